@@ -0,0 +1,281 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <cstdint>
+#include <map>
+#include <vector>
+#include "Memory.h"
+#include "AccessProfile.h"
+
+AccessProfile * AccessProfile::profileInstance = NULL;
+bool AccessProfile::enabled = false;
+
+/*
+ * AccessProfile constructor
+ * starts with no accesses and the default window
+ */
+AccessProfile::AccessProfile()
+{
+   window = ACCESSWINDOW;
+   cycles = 0;
+   for (int32_t i = 0; i < ACCESSLINES; i++)
+      for (int32_t j = 0; j < NUMACCESS; j++) counts[i][j] = 0;
+   for (int32_t k = 0; k < 2; k++)
+   {
+      for (int32_t i = 0; i < REUSEBINS; i++) reuse[k][i] = 0;
+      for (int32_t i = 0; i < ACCESSLINES; i++) touched[k][i] = false;
+      depth[k] = 0;
+   }
+}
+
+/*
+ * getInstance
+ * if profileInstance is NULL then creates an AccessProfile object
+ * and sets profileInstance to point to it; returns profileInstance
+ *
+ * @return profileInstance
+ */
+AccessProfile * AccessProfile::getInstance()
+{
+   if (profileInstance == NULL)
+   {
+      profileInstance = new AccessProfile();
+   }
+   return profileInstance;
+}
+
+/*
+ * setEnabled
+ * @param enabled - true if the stages report their accesses from now on
+ */
+void AccessProfile::setEnabled(bool enabled)
+{
+   AccessProfile::enabled = enabled;
+}
+
+/*
+ * setWindow
+ * @param window - cycles in each window of the working set report
+ */
+void AccessProfile::setWindow(uint64_t window)
+{
+   this->window = window;
+}
+
+/*
+ * fetch
+ * called by the fetch stage every cycle with the address it fetched
+ * from; a stalled fetch counts as another access to the same address
+ *
+ * @param address - address of the first byte of the instruction
+ */
+void AccessProfile::fetch(int32_t address)
+{
+   if (address >= 0 && address < MEMSIZE)
+   {
+      counts[address / ACCESSLINE][ACCESSFETCH]++;
+      access(ACCESSFETCH, address / ACCESSLINE);
+   }
+   cycles++;
+   if (cycles % window == 0) endWindow();
+}
+
+/*
+ * data
+ * called by the memory stage with the address of each word it reads
+ * or writes (an exchange does both)
+ *
+ * @param pc - address of the instruction in the memory stage
+ * @param address - address of the word
+ * @param read - true if the word was read
+ * @param write - true if the word was written
+ */
+void AccessProfile::data(uint64_t pc, int32_t address, bool read, bool write)
+{
+   if (address < 0 || address >= MEMSIZE) return;
+   int32_t line = address / ACCESSLINE;
+   if (read) counts[line][ACCESSREAD]++;
+   if (write) counts[line][ACCESSWRITE]++;
+   access(ACCESSREAD, line);
+
+   PcAccesses & accesses = pcs[pc];
+   if (accesses.reads + accesses.writes > 0)
+      accesses.strides[(int64_t) address - accesses.last]++;
+   if (read) accesses.reads++;
+   if (write) accesses.writes++;
+   accesses.last = address;
+}
+
+/*
+ * access
+ * adds an access to line to the reuse histogram of the fetches
+ * (ACCESSFETCH) or of the data accesses (any other kind). The reuse
+ * distance is the number of other lines accessed since the last access
+ * to line, which is the position of line in a stack of the lines kept
+ * in the order of their last accesses.
+ */
+void AccessProfile::access(int32_t kind, int32_t line)
+{
+   int32_t k = kind == ACCESSFETCH ? 0 : 1;
+   int32_t * lines = stack[k];
+   int32_t position = 0;
+   while (position < depth[k] && lines[position] != line) position++;
+
+   int32_t bin = REUSECOLD;
+   if (position < depth[k])
+   {
+      bin = 0;
+      while ((1 << bin) <= position) bin++;
+   }
+   else depth[k]++;
+   reuse[k][bin]++;
+
+   //move the line to the top of the stack
+   for (int32_t i = position; i > 0; i--) lines[i] = lines[i - 1];
+   lines[0] = line;
+   touched[k][line] = true;
+}
+
+/*
+ * endWindow
+ * records the number of lines touched since the last window ended
+ * and starts a new window
+ */
+void AccessProfile::endWindow()
+{
+   WorkingSet set = {0, 0, 0, 0};
+   set.start = sets.size() * window;
+   for (int32_t i = 0; i < ACCESSLINES; i++)
+   {
+      if (touched[0][i]) set.fetchLines++;
+      if (touched[1][i]) set.dataLines++;
+      if (touched[0][i] || touched[1][i]) set.lines++;
+      touched[0][i] = touched[1][i] = false;
+   }
+   sets.push_back(set);
+}
+
+/*
+ * dump
+ * outputs the reuse distance histograms, the working set of each
+ * window, the strides of each instruction that accessed memory and the
+ * heat map of the lines
+ */
+void AccessProfile::dump()
+{
+   if (cycles % window != 0) endWindow();
+   std::cout << std::dec << "\nMemory accesses (" << cycles
+             << " cycles, " << ACCESSLINE << " byte lines):" << std::endl;
+   dumpReuse();
+   dumpWorkingSets();
+   dumpStrides();
+   dumpHeatMap();
+}
+
+/*
+ * dumpReuse
+ * outputs the number of fetches and data accesses in each bin of
+ * reuse distances
+ */
+void AccessProfile::dumpReuse()
+{
+   std::cout << "\nreuse distance      fetch       data" << std::endl;
+   for (int32_t bin = 0; bin < REUSEBINS; bin++)
+   {
+      std::string range = "cold";
+      if (bin < 2) range = std::to_string(bin);
+      else if (bin != REUSECOLD) range = std::to_string(1 << (bin - 1)) +
+                                         "-" + std::to_string((1 << bin) - 1);
+      std::cout << std::setw(14) << range << " " << std::setw(10)
+                << reuse[0][bin] << " " << std::setw(10) << reuse[1][bin] << std::endl;
+   }
+}
+
+/*
+ * dumpWorkingSets
+ * outputs the number of distinct lines fetched, accessed as data and
+ * touched by either in each window of cycles
+ */
+void AccessProfile::dumpWorkingSets()
+{
+   std::cout << "\nworking set  window of " << window << " cycles"
+             << std::endl << "       cycle      fetch       data      total"
+             << std::endl;
+   for (uint64_t i = 0; i < sets.size(); i++)
+      std::cout << std::setw(12) << sets[i].start << " "
+                << std::setw(10) << sets[i].fetchLines << " "
+                << std::setw(10) << sets[i].dataLines << " "
+                << std::setw(10) << sets[i].lines << std::endl;
+}
+
+/*
+ * dumpStrides
+ * outputs, for each instruction that read or wrote memory, its number
+ * of reads and writes, the stride between its successive addresses
+ * that was seen most often and the share of the strides that were
+ * that one
+ */
+void AccessProfile::dumpStrides()
+{
+   std::cout << "\nstrides\n pc:      reads     writes     stride      share"
+             << std::endl;
+   std::map<uint64_t, PcAccesses>::iterator it;
+   for (it = pcs.begin(); it != pcs.end(); it++)
+   {
+      PcAccesses & accesses = it->second;
+      std::cout << std::hex << std::setw(3) << std::setfill('0')
+                << it->first << std::dec << std::setfill(' ') << ": "
+                << std::setw(10) << accesses.reads << " "
+                << std::setw(10) << accesses.writes << " ";
+      uint64_t strides = 0, best = 0;
+      int64_t stride = 0;
+      std::map<int64_t, uint64_t>::iterator s;
+      for (s = accesses.strides.begin(); s != accesses.strides.end(); s++)
+      {
+         strides += s->second;
+         if (s->second > best)
+         {
+            best = s->second;
+            stride = s->first;
+         }
+      }
+      if (strides == 0) std::cout << std::setw(10) << "-" << std::endl;
+      else std::cout << std::setw(10) << stride << " " << std::setw(9)
+                     << std::fixed << std::setprecision(1)
+                     << 100.0 * best / strides << "%" << std::endl;
+   }
+   std::cout.unsetf(std::ios::floatfield);
+   std::cout << std::setprecision(6);
+}
+
+/*
+ * dumpHeatMap
+ * outputs the fetches, reads and writes of each line in the layout of
+ * Memory::dump: a line that has the same counts as the previous line
+ * is not displayed and a * marks where lines were left out
+ */
+void AccessProfile::dumpHeatMap()
+{
+   std::cout << "\nheat map\nline:      fetch       read      write";
+   bool star = false;
+   for (int32_t i = 0; i < ACCESSLINES; i++)
+   {
+      if (i == 0 || counts[i][ACCESSFETCH] != counts[i - 1][ACCESSFETCH] ||
+          counts[i][ACCESSREAD] != counts[i - 1][ACCESSREAD] ||
+          counts[i][ACCESSWRITE] != counts[i - 1][ACCESSWRITE])
+      {
+         std::cout << std::endl << std::setw(3) << std::setfill('0')
+                   << std::hex << i * ACCESSLINE << ":" << std::dec
+                   << std::setfill(' ');
+         for (int32_t j = 0; j < NUMACCESS; j++)
+            std::cout << " " << std::setw(10) << counts[i][j];
+         star = false;
+      }
+      else
+      {
+         if (star == false) std::cout << "*";
+         star = true;
+      }
+   }
+   std::cout << std::endl;
+}
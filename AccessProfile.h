@@ -0,0 +1,84 @@
+#include <cstdint>
+#include <map>
+#include <vector>
+#ifndef ACCESSPROFILE_H
+#define ACCESSPROFILE_H
+
+//accesses are grouped by the 32 byte lines of Memory::dump
+#define ACCESSLINE 32
+#define ACCESSLINES (MEMSIZE / ACCESSLINE)
+//reuse distances are binned by powers of two: 0, 1, 2-3, ..., with a
+//last bin for the first access to a line
+#define REUSEBINS 9
+#define REUSECOLD (REUSEBINS - 1)
+//default number of cycles in each working set window
+#define ACCESSWINDOW 100
+
+//the kinds of access that are counted
+#define ACCESSFETCH 0
+#define ACCESSREAD 1
+#define ACCESSWRITE 2
+#define NUMACCESS 3
+
+//addresses seen by one instruction of the memory stage
+struct PcAccesses
+{
+   uint64_t reads;
+   uint64_t writes;
+   int32_t last;                        //address of the previous access
+   std::map<int64_t, uint64_t> strides; //times each stride was seen
+};
+
+//distinct lines touched in one window of cycles
+struct WorkingSet
+{
+   uint64_t start;       //first cycle of the window
+   uint64_t fetchLines;
+   uint64_t dataLines;
+   uint64_t lines;       //lines touched by a fetch or a data access
+};
+
+//records the address fetched by the fetch stage and the addresses read
+//and written by the memory stage in every cycle of a pipeline run.
+//The stages only call it while it is enabled, so a run that is not
+//profiled costs one test of a flag per access.
+class AccessProfile
+{
+   private:
+      static AccessProfile * profileInstance;
+      static bool enabled;
+      AccessProfile();
+      uint64_t window;                          //cycles in a working set window
+      uint64_t cycles;                          //one fetch per cycle
+      uint64_t counts[ACCESSLINES][NUMACCESS];  //heat map
+      uint64_t reuse[2][REUSEBINS];             //fetch and data histograms
+      int32_t stack[2][ACCESSLINES];            //lines, most recent first
+      int32_t depth[2];                         //lines in each stack
+      bool touched[2][ACCESSLINES];             //lines seen in this window
+      std::map<uint64_t, PcAccesses> pcs;
+      std::vector<WorkingSet> sets;
+      void access(int32_t kind, int32_t line);
+      void endWindow();
+      void dumpReuse();
+      void dumpWorkingSets();
+      void dumpStrides();
+      void dumpHeatMap();
+   public:
+      static AccessProfile * getInstance();
+      static void setEnabled(bool enabled);
+      static bool isEnabled();
+      void setWindow(uint64_t window);
+      void fetch(int32_t address);
+      void data(uint64_t pc, int32_t address, bool read, bool write);
+      void dump();
+};
+
+/*
+ * isEnabled
+ * @return true if the stages report their accesses
+ */
+inline bool AccessProfile::isEnabled()
+{
+   return enabled;
+}
+#endif
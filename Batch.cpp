@@ -0,0 +1,415 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <string.h>
+#include "Memory.h"
+#include "RegisterFile.h"
+#include "ConditionCodes.h"
+#include "Tools.h"
+#include "Status.h"
+#include "Instructions.h"
+#include "InstrTable.h"
+#include "Batch.h"
+
+//lane numbers of a step in which every lane runs: the loops over
+//them index the arrays directly, so they can be vectorised
+struct AllLanes
+{
+   uint32_t operator[](uint64_t i) const { return i; }
+};
+
+//lane numbers of a step run by a group of the lanes
+struct GroupLanes
+{
+   const uint32_t * lanes;
+   uint32_t operator[](uint64_t i) const { return lanes[i]; }
+};
+
+/*
+ * Batch constructor
+ * gives every lane a copy of the Memory, RegisterFile and
+ * ConditionCodes and sets %rdi of lane i to i
+ *
+ * @param lanes - number of machines (1 to MAXLANES)
+ */
+Batch::Batch(uint64_t lanes)
+{
+   bool error = false;
+   this->lanes = lanes;
+   for (int32_t r = 0; r < REGSIZE + 2; r++)
+   {
+      uint64_t value = r < REGSIZE ?
+                       RegisterFile::getInstance()->readRegister(r, error) : 0;
+      reg[r].assign(lanes, value);
+   }
+   for (uint64_t lane = 0; lane < lanes; lane++) reg[RDI][lane] = lane;
+   ConditionCodes * cc = ConditionCodes::getInstance();
+   zf.assign(lanes, cc->getConditionCode(ZF, error));
+   sf.assign(lanes, cc->getConditionCode(SF, error));
+   of.assign(lanes, cc->getConditionCode(OF, error));
+   pc.assign(lanes, 0);
+   stat.assign(lanes, SAOK);
+   executed.assign(lanes, 0);
+   operand.assign(lanes, 0);
+   mem.resize(lanes * MEMSIZE);
+   for (int32_t i = 0; i < MEMSIZE; i++)
+      mem[i] = Memory::getInstance()->getByte(i, error);
+   for (uint64_t lane = 1; lane < lanes; lane++)
+      memcpy(&mem[lane * MEMSIZE], &mem[0], MEMSIZE);
+   lockstep = 0;
+   divergent = 0;
+   seconds = 0;
+}
+
+/*
+ * dest
+ * @return array of register regNum to write, or an array whose values
+ *         are never read if regNum is RNONE
+ */
+uint64_t * Batch::dest(uint64_t regNum)
+{
+   return reg[regNum < REGSIZE ? regNum : REGSIZE + 1].data();
+}
+
+/*
+ * load, store
+ * read or write the 64-bit word at address in the memory of lane
+ *
+ * @return false if the address is not aligned or out of range
+ */
+bool Batch::load(uint64_t lane, uint64_t address, uint64_t & value)
+{
+   if (address % 8 != 0 || address > MEMSIZE - 8) return false;
+   memcpy(&value, &mem[lane * MEMSIZE + address], LONGSIZE);
+   return true;
+}
+
+bool Batch::store(uint64_t lane, uint64_t address, uint64_t value)
+{
+   if (address % 8 != 0 || address > MEMSIZE - 8) return false;
+   memcpy(&mem[lane * MEMSIZE + address], &value, LONGSIZE);
+   return true;
+}
+
+/*
+ * run
+ * executes steps until every lane has stopped; each step executes
+ * the instruction at the lowest address of the running lanes in
+ * every running lane at that address whose instruction bytes are
+ * those of the first such lane
+ */
+void Batch::run()
+{
+   std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+   group.resize(lanes);
+   while (true)
+   {
+      uint64_t running = 0;
+      uint64_t address = MEMSIZE;
+      for (uint64_t lane = 0; lane < lanes; lane++)
+      {
+         if (stat[lane] != SAOK) continue;
+         running++;
+         if (pc[lane] < address) address = pc[lane];
+      }
+      if (running == 0) break;
+
+      uint64_t count = 0;
+      const uint8_t * code = NULL;
+      uint64_t length = std::min((uint64_t) 10, MEMSIZE - address);
+      for (uint64_t lane = 0; lane < lanes; lane++)
+      {
+         if (stat[lane] != SAOK || pc[lane] != address) continue;
+         //lanes whose code was changed by a store run in a later step
+         const uint8_t * bytes = &mem[lane * MEMSIZE + address];
+         if (code == NULL) code = bytes;
+         else if (memcmp(code, bytes, length) != 0) continue;
+         group[count++] = lane;
+      }
+
+      if (count == lanes)
+      {
+         AllLanes all;
+         execute(all, count, address);
+         lockstep++;
+      }
+      else
+      {
+         GroupLanes some = {group.data()};
+         execute(some, count, address);
+         if (count == running) lockstep++;
+         else divergent++;
+      }
+   }
+   seconds = std::chrono::duration<double>(std::chrono::steady_clock::now()
+                                           - start).count();
+}
+
+/*
+ * execute
+ * executes the instruction at address in count lanes, which all hold
+ * the same bytes there
+ *
+ * @param lanes - lanes[i] is the number of the ith lane
+ */
+template <class Lanes>
+void Batch::execute(const Lanes & lanes, uint64_t count, uint64_t address)
+{
+   const uint8_t * code = &mem[lanes[0] * MEMSIZE + address];
+   uint64_t icode = code[0] >> 4;
+   uint64_t ifun = code[0] & 0xf;
+   const InstrProps & props = InstrTable::lookup(icode, ifun);
+   uint64_t status = !props.valid ? SINS :
+                     address + props.length > MEMSIZE ? SADR : SAOK;
+   if (status == SAOK && icode == IHALT) status = SHLT;
+   if (status != SAOK)
+   {
+      for (uint64_t i = 0; i < count; i++) stat[lanes[i]] = status;
+      if (status == SHLT)
+         for (uint64_t i = 0; i < count; i++) executed[lanes[i]]++;
+      return;
+   }
+
+   uint64_t rA = props.needRegIds ? code[1] >> 4 : RNONE;
+   uint64_t rB = props.needRegIds ? code[1] & 0xf : RNONE;
+   uint64_t valC = 0;
+   for (int32_t i = 0; props.needValC && i < LONGSIZE; i++)
+      valC |= (uint64_t) code[1 + props.needRegIds + i] << (8 * i);
+   uint64_t valP = address + props.length;
+   const uint64_t * a = reg[rA < REGSIZE ? rA : REGSIZE].data();
+   uint64_t * b = dest(rB);
+   uint64_t * rsp = reg[RSP].data();
+   uint64_t value = 0;
+
+   switch (icode)
+   {
+      case IRRMOVQ:
+         for (uint64_t i = 0; i < count; i++)
+         {
+            uint32_t l = lanes[i];
+            if (InstrTable::cond(ifun, zf[l], sf[l], of[l])) b[l] = a[l];
+         }
+         break;
+      case IIRMOVQ:
+         for (uint64_t i = 0; i < count; i++) b[lanes[i]] = valC;
+         break;
+      case IRMMOVQ:
+         for (uint64_t i = 0; i < count; i++)
+         {
+            uint32_t l = lanes[i];
+            if (!store(l, reg[rB < REGSIZE ? rB : REGSIZE][l] + valC, a[l]))
+               stat[l] = SADR;
+         }
+         break;
+      case IMRMOVQ:
+         //each lane gathers a word from its own memory
+         for (uint64_t i = 0; i < count; i++)
+         {
+            uint32_t l = lanes[i];
+            if (!load(l, reg[rB < REGSIZE ? rB : REGSIZE][l] + valC, value))
+               stat[l] = SADR;
+            else dest(rA)[l] = value;
+         }
+         break;
+      case IOPQ:
+         opq(lanes, count, ifun, a, rB);
+         break;
+      case IIADDQ:
+         for (uint64_t i = 0; i < count; i++) operand[lanes[i]] = valC;
+         opq(lanes, count, ADDQ, operand.data(), rB);
+         break;
+      case IJXX:
+         for (uint64_t i = 0; i < count; i++)
+         {
+            uint32_t l = lanes[i];
+            pc[l] = InstrTable::cond(ifun, zf[l], sf[l], of[l]) ? valC : valP;
+            executed[l]++;
+         }
+         return;
+      case ICALL:
+         for (uint64_t i = 0; i < count; i++)
+         {
+            uint32_t l = lanes[i];
+            if (!store(l, rsp[l] - 8, valP)) stat[l] = SADR;
+            else
+            {
+               rsp[l] -= 8;
+               pc[l] = valC;
+               executed[l]++;
+            }
+         }
+         return;
+      case IRET:
+         for (uint64_t i = 0; i < count; i++)
+         {
+            uint32_t l = lanes[i];
+            if (!load(l, rsp[l], value)) stat[l] = SADR;
+            else
+            {
+               rsp[l] += 8;
+               pc[l] = value;
+               executed[l]++;
+            }
+         }
+         return;
+      case IPUSHQ:
+         for (uint64_t i = 0; i < count; i++)
+         {
+            uint32_t l = lanes[i];
+            if (!store(l, rsp[l] - 8, a[l])) stat[l] = SADR;
+            else rsp[l] -= 8;
+         }
+         break;
+      case IPOPQ:
+         for (uint64_t i = 0; i < count; i++)
+         {
+            uint32_t l = lanes[i];
+            if (!load(l, rsp[l], value)) stat[l] = SADR;
+            else
+            {
+               rsp[l] += 8;
+               dest(rA)[l] = value;
+            }
+         }
+         break;
+      case ILEAVE:
+         for (uint64_t i = 0; i < count; i++)
+         {
+            uint32_t l = lanes[i];
+            if (!load(l, reg[RBP][l], value)) stat[l] = SADR;
+            else
+            {
+               rsp[l] = reg[RBP][l] + 8;
+               reg[RBP][l] = value;
+            }
+         }
+         break;
+      case IXCHGQ:
+         for (uint64_t i = 0; i < count; i++)
+         {
+            uint32_t l = lanes[i];
+            uint64_t addr = reg[rB < REGSIZE ? rB : REGSIZE][l] + valC;
+            if (!load(l, addr, value) || !store(l, addr, a[l]))
+               stat[l] = SADR;
+            else dest(rA)[l] = value;
+         }
+         break;
+   }
+
+   //every instruction that does not jump continues at valP
+   for (uint64_t i = 0; i < count; i++)
+   {
+      uint32_t l = lanes[i];
+      if (stat[l] != SAOK) continue;
+      pc[l] = valP;
+      executed[l]++;
+   }
+}
+
+/*
+ * opq
+ * applies ALU function ifun to opA and register rB in count lanes,
+ * writing the result to rB and updating the condition codes. The
+ * base functions have loops without calls or branches on the data.
+ */
+template <class Lanes>
+void Batch::opq(const Lanes & lanes, uint64_t count, uint64_t ifun,
+                const uint64_t * opA, uint64_t rB)
+{
+   uint64_t * b = dest(rB);
+   const uint64_t * opB = reg[rB < REGSIZE ? rB : REGSIZE].data();
+   switch (ifun)
+   {
+      case ADDQ:
+         for (uint64_t i = 0; i < count; i++)
+         {
+            uint32_t l = lanes[i];
+            uint64_t result = opB[l] + opA[l];
+            of[l] = ((opA[l] ^ result) & (opB[l] ^ result)) >> 63;
+            zf[l] = result == 0;
+            sf[l] = result >> 63;
+            b[l] = result;
+         }
+         break;
+      case SUBQ:
+         for (uint64_t i = 0; i < count; i++)
+         {
+            uint32_t l = lanes[i];
+            uint64_t result = opB[l] - opA[l];
+            of[l] = ((opB[l] ^ opA[l]) & (opB[l] ^ result)) >> 63;
+            zf[l] = result == 0;
+            sf[l] = result >> 63;
+            b[l] = result;
+         }
+         break;
+      case ANDQ:
+      case XORQ:
+         //the overflow flag keeps its value
+         for (uint64_t i = 0; i < count; i++)
+         {
+            uint32_t l = lanes[i];
+            uint64_t result = ifun == ANDQ ? opA[l] & opB[l] : opA[l] ^ opB[l];
+            zf[l] = result == 0;
+            sf[l] = result >> 63;
+            b[l] = result;
+         }
+         break;
+      default:
+         for (uint64_t i = 0; i < count; i++)
+         {
+            uint32_t l = lanes[i];
+            uint64_t result = InstrTable::alu(opA[l], opB[l], ifun);
+            of[l] = InstrTable::overflow(opA[l], opB[l], ifun, of[l]);
+            zf[l] = result == 0;
+            sf[l] = result >> 63;
+            b[l] = result;
+         }
+   }
+}
+
+/*
+ * getInstructions
+ * @return instructions executed by all of the lanes
+ */
+uint64_t Batch::getInstructions()
+{
+   uint64_t instructions = 0;
+   for (uint64_t lane = 0; lane < lanes; lane++) instructions += executed[lane];
+   return instructions;
+}
+
+/*
+ * dump
+ * outputs the aggregate instructions per second and the share of the
+ * steps run in lockstep, the status, pc and instruction count of each
+ * lane, and the condition codes, registers and memory of lane 0
+ */
+void Batch::dump()
+{
+   uint64_t instructions = getInstructions();
+   uint64_t steps = lockstep + divergent;
+   std::cout << "\nAt end of batch run:" << std::endl;
+   std::cout << std::dec << "lanes: " << lanes << " instructions: "
+             << instructions << " steps: " << steps << " lockstep: "
+             << lockstep << " divergent: " << divergent
+             << " instructions/second: " << (uint64_t) (instructions / seconds)
+             << std::endl;
+   for (uint64_t lane = 0; lane < lanes; lane++)
+      std::cout << std::dec << "lane " << lane << ": stat: " << std::hex
+                << stat[lane] << " pc: " << std::setw(3) << std::setfill('0')
+                << pc[lane] << std::dec << " instructions: "
+                << executed[lane] << std::endl;
+
+   uint64_t regs[REGSIZE];
+   uint64_t words[MEMSIZE / 8];
+   for (int32_t r = 0; r < REGSIZE; r++) regs[r] = reg[r][0];
+   for (int32_t i = 0; i < MEMSIZE / 8; i++) load(0, i * 8, words[i]);
+   std::cout << "\nlane 0:" << std::endl;
+   ConditionCodes::dump(std::cout, (uint64_t) zf[0] << ZF |
+                        (uint64_t) sf[0] << SF | (uint64_t) of[0] << OF);
+   RegisterFile::dump(std::cout, regs);
+   Memory::dump(std::cout, words);
+}
@@ -0,0 +1,48 @@
+#include <cstdint>
+#include <vector>
+#ifndef BATCH_H
+#define BATCH_H
+
+//most machines in a batch
+#define MAXLANES 4096
+
+//runs the program in Memory on lanes independent machines, machine
+//(lane) i starting with i in %rdi. The registers, condition codes and
+//program counters of the machines are stored as arrays with one
+//element per lane, so each instruction is applied to every lane that
+//is at its address by a loop over the lanes. At each step the lanes
+//at the lowest address execute together; while all of the lanes agree
+//on the address the loops run over consecutive lanes and the compiler
+//can vectorise them, and lanes that take different branches run in
+//smaller groups, down to one lane, until they meet again.
+class Batch
+{
+   private:
+      uint64_t lanes;
+      std::vector<uint64_t> reg[REGSIZE + 2];   //RNONE reads 0; the last
+                                                //array absorbs writes to RNONE
+      std::vector<uint8_t> zf, sf, of;
+      std::vector<uint64_t> pc;
+      std::vector<uint64_t> stat;
+      std::vector<uint64_t> executed;           //instructions of each lane
+      std::vector<uint8_t> mem;                 //MEMSIZE bytes per lane
+      std::vector<uint32_t> group;              //lanes of the current step
+      std::vector<uint64_t> operand;            //valC of iaddq in each lane
+      uint64_t lockstep;      //steps in which every running lane executed
+      uint64_t divergent;     //steps run by only some of the lanes
+      double seconds;         //host time of run
+      uint64_t * dest(uint64_t regNum);
+      bool load(uint64_t lane, uint64_t address, uint64_t & value);
+      bool store(uint64_t lane, uint64_t address, uint64_t value);
+      template <class Lanes>
+      void execute(const Lanes & lanes, uint64_t count, uint64_t address);
+      template <class Lanes>
+      void opq(const Lanes & lanes, uint64_t count, uint64_t ifun,
+               const uint64_t * opA, uint64_t rB);
+   public:
+      Batch(uint64_t lanes);
+      void run();
+      uint64_t getInstructions();
+      void dump();
+};
+#endif
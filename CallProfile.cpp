@@ -0,0 +1,215 @@
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <string>
+#include <cstdint>
+#include <map>
+#include <vector>
+#include <algorithm>
+#include "Instructions.h"
+#include "PipeReg.h"
+#include "SymbolTable.h"
+#include "CallProfile.h"
+
+CallProfile * CallProfile::profileInstance = NULL;
+bool CallProfile::enabled = false;
+
+/*
+ * CallProfile constructor
+ * starts in the entry point of the program, address 0
+ */
+CallProfile::CallProfile()
+{
+   CallNode root;
+   root.function = 0;
+   root.parent = 0;
+   root.calls = 1;
+   root.cycles = 0;
+   nodes.push_back(root);
+   current = 0;
+   calling = false;
+   cycles = 0;
+}
+
+/*
+ * getInstance
+ * if profileInstance is NULL then creates a CallProfile object
+ * and sets profileInstance to point to it; returns profileInstance
+ *
+ * @return profileInstance
+ */
+CallProfile * CallProfile::getInstance()
+{
+   if (profileInstance == NULL)
+   {
+      profileInstance = new CallProfile();
+   }
+   return profileInstance;
+}
+
+/*
+ * setEnabled
+ * @param enabled - true to attribute the cycles from now on
+ */
+void CallProfile::setEnabled(bool enabled)
+{
+   CallProfile::enabled = enabled;
+}
+
+/*
+ * retire
+ * called every cycle with the instruction in the W register; charges
+ * the cycle to the current call path, after entering the callee if
+ * this is the first instruction since a call and before leaving it if
+ * this is a ret
+ *
+ * @param icode - icode of the W register
+ * @param pc - pc of the W register, NOPC for a bubble
+ */
+void CallProfile::retire(uint64_t icode, uint64_t pc)
+{
+   if (pc != NOPC && calling)
+   {
+      call(pc);
+      calling = false;
+   }
+   nodes[current].cycles++;
+   cycles++;
+   if (pc == NOPC) return;
+   if (icode == ICALL) calling = true;
+   //a ret without a matching call leaves the program in the entry point
+   if (icode == IRET && current != 0) current = nodes[current].parent;
+}
+
+/*
+ * call
+ * makes the path from the current path to function the current path,
+ * adding it to the tree the first time it is taken
+ */
+void CallProfile::call(uint64_t function)
+{
+   std::map<uint64_t, uint32_t>::iterator it =
+      nodes[current].children.find(function);
+   uint32_t node;
+   if (it != nodes[current].children.end()) node = it->second;
+   else
+   {
+      CallNode callee;
+      callee.function = function;
+      callee.parent = current;
+      callee.calls = 0;
+      callee.cycles = 0;
+      node = nodes.size();
+      nodes.push_back(callee);
+      nodes[current].children[function] = node;
+   }
+   current = node;
+   nodes[current].calls++;
+}
+
+/*
+ * addCycles
+ * adds the cycles of node and of the nodes below it to the functions.
+ * active counts the times each function is on the path to node, so a
+ * recursive function gets the inclusive cycles of a path only once.
+ */
+void CallProfile::addCycles(uint32_t node, std::map<uint64_t, int32_t> & active,
+                            std::map<uint64_t, FunctionCycles> & functions)
+{
+   uint64_t function = nodes[node].function;
+   FunctionCycles & totals = functions[function];
+   totals.function = function;
+   totals.calls += nodes[node].calls;
+   totals.exclusive += nodes[node].cycles;
+   active[function]++;
+   std::map<uint64_t, int32_t>::iterator it;
+   for (it = active.begin(); it != active.end(); it++)
+      if (it->second > 0) functions[it->first].inclusive += nodes[node].cycles;
+   std::map<uint64_t, uint32_t>::iterator child;
+   for (child = nodes[node].children.begin();
+        child != nodes[node].children.end(); child++)
+      addCycles(child->second, active, functions);
+   active[function]--;
+}
+
+/*
+ * byInclusive
+ * orders functions by decreasing inclusive cycles, then by address
+ */
+static bool byInclusive(const FunctionCycles & a, const FunctionCycles & b)
+{
+   if (a.inclusive != b.inclusive) return a.inclusive > b.inclusive;
+   return a.function < b.function;
+}
+
+/*
+ * dump
+ * outputs the calls, inclusive cycles and exclusive cycles of each
+ * function, named by its label if it has one, most inclusive first
+ */
+void CallProfile::dump()
+{
+   std::map<uint64_t, int32_t> active;
+   std::map<uint64_t, FunctionCycles> functions;
+   addCycles(0, active, functions);
+   std::vector<FunctionCycles> order;
+   std::map<uint64_t, FunctionCycles>::iterator it;
+   for (it = functions.begin(); it != functions.end(); it++)
+      order.push_back(it->second);
+   std::sort(order.begin(), order.end(), byInclusive);
+
+   SymbolTable * symbols = SymbolTable::getInstance();
+   std::cout << std::dec << "\nCall profile (" << cycles << " cycles, "
+             << nodes.size() << " call paths):" << std::endl;
+   std::cout << "        function      calls  inclusive       %"
+             << "  exclusive       %" << std::endl;
+   std::cout << std::fixed << std::setprecision(1);
+   for (uint64_t i = 0; i < order.size(); i++)
+   {
+      FunctionCycles & f = order[i];
+      std::cout << std::setw(16) << symbols->name(f.function) << " "
+                << std::setw(10) << f.calls << " "
+                << std::setw(10) << f.inclusive << " " << std::setw(6)
+                << 100.0 * f.inclusive / cycles << "% "
+                << std::setw(10) << f.exclusive << " " << std::setw(6)
+                << 100.0 * f.exclusive / cycles << "%" << std::endl;
+   }
+   std::cout.unsetf(std::ios::floatfield);
+   std::cout << std::setprecision(6);
+}
+
+/*
+ * writeFolded
+ * writes the cycles of each call path in the folded stack format read
+ * by flame graph tools: the functions on the path from the entry point
+ * separated by semicolons, a space and the cycles spent in the last
+ * function, one path per line
+ *
+ * @param fileName - name of the file to write
+ * @return false if the file cannot be written
+ */
+bool CallProfile::writeFolded(const char * fileName)
+{
+   std::ofstream out(fileName);
+   if (!out.is_open()) return false;
+   writeFolded(0, "", out);
+   return out.good();
+}
+
+/*
+ * writeFolded
+ * writes the line of node, whose caller's path is path, and the lines
+ * of the nodes below it
+ */
+void CallProfile::writeFolded(uint32_t node, const std::string & path,
+                              std::ostream & out)
+{
+   std::string name = SymbolTable::getInstance()->name(nodes[node].function);
+   std::string folded = path.empty() ? name : path + ";" + name;
+   if (nodes[node].cycles > 0)
+      out << folded << " " << nodes[node].cycles << "\n";
+   std::map<uint64_t, uint32_t>::iterator child;
+   for (child = nodes[node].children.begin();
+        child != nodes[node].children.end(); child++)
+      writeFolded(child->second, folded, out);
+}
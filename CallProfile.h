@@ -0,0 +1,67 @@
+#include <cstdint>
+#include <map>
+#include <vector>
+#include <string>
+#include <ostream>
+#ifndef CALLPROFILE_H
+#define CALLPROFILE_H
+
+//a node of the calling context tree: one call path from the entry
+//point of the program down to function
+struct CallNode
+{
+   uint64_t function;                    //address the path last called
+   uint32_t parent;                      //index of the caller's node
+   uint64_t calls;                       //times the path was entered
+   uint64_t cycles;                      //cycles spent in function itself
+   std::map<uint64_t, uint32_t> children; //callee address to node index
+};
+
+//cycles of a function over every path it appears on
+struct FunctionCycles
+{
+   uint64_t function;
+   uint64_t calls;
+   uint64_t inclusive;   //cycles in the function and its callees
+   uint64_t exclusive;   //cycles in the function itself
+};
+
+//attributes each cycle of a pipeline run to the call path of the
+//instruction in the W register. A shadow call stack is kept as a
+//path in the calling context tree: a call that reaches W makes the
+//address of the next instruction to reach W the current function and
+//a ret returns to the caller. The Simulate object only reports to it
+//while it is enabled.
+class CallProfile
+{
+   private:
+      static CallProfile * profileInstance;
+      static bool enabled;
+      CallProfile();
+      std::vector<CallNode> nodes;   //nodes[0] is the entry point
+      uint32_t current;              //node of the current path
+      bool calling;                  //a call reached W; next pc is the callee
+      uint64_t cycles;
+      void call(uint64_t function);
+      void addCycles(uint32_t node, std::map<uint64_t, int32_t> & active,
+                     std::map<uint64_t, FunctionCycles> & functions);
+      void writeFolded(uint32_t node, const std::string & path,
+                       std::ostream & out);
+   public:
+      static CallProfile * getInstance();
+      static void setEnabled(bool enabled);
+      static bool isEnabled();
+      void retire(uint64_t icode, uint64_t pc);
+      void dump();
+      bool writeFolded(const char * fileName);
+};
+
+/*
+ * isEnabled
+ * @return true if the cycles are being attributed to call paths
+ */
+inline bool CallProfile::isEnabled()
+{
+   return enabled;
+}
+#endif
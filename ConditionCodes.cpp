@@ -4,8 +4,9 @@
 #include "Tools.h"
 
 //cc_instance will be initialized to reference the single 
-//instance of ConditionCodes
-ConditionCodes * ConditionCodes::ccInstance = NULL;
+//instance of ConditionCodes; a multicore run points each host
+//thread's ccInstance at the condition codes of the core it simulates
+thread_local ConditionCodes * ConditionCodes::ccInstance = NULL;
 
 /**
  * ConditionCodes constructor
@@ -33,6 +34,29 @@ ConditionCodes * ConditionCodes::getInstance()
    return ccInstance;
 }
 
+/**
+ * create
+ * creates further ConditionCodes, for another simulated core
+ *
+ * @return pointer to the new ConditionCodes with every code 0
+ */
+ConditionCodes * ConditionCodes::create()
+{
+   return new ConditionCodes();
+}
+
+/**
+ * setInstance
+ * makes instance the ConditionCodes that getInstance returns to the
+ * calling thread
+ *
+ * @param instance - condition codes of the core being simulated
+ */
+void ConditionCodes::setInstance(ConditionCodes * instance)
+{
+   ccInstance = instance;
+}
+
 /*
  * getConditionCode
  * accepts a condition code number (OF, SF, or ZF) and returns 
@@ -91,17 +115,40 @@ void ConditionCodes::setConditionCode(bool value, int32_t ccNum,
 
 }
 
+/*
+ * reset
+ * clears all of the condition codes
+ */
+void ConditionCodes::reset()
+{
+   codes = 0;
+}
+
 /*
  * dump
  * outputs the values of the condition codes
  */
 void ConditionCodes::dump()
+{
+   dump(std::cout, codes);
+}
+
+/*
+ * dump
+ * outputs the condition codes held in codes to out in the format
+ * used by dump()
+ *
+ * @param out - stream to write to
+ * @param codes - condition codes register, with ZF, SF and OF at
+ *                their bit positions
+ */
+void ConditionCodes::dump(std::ostream & out, uint64_t codes)
 {
    int32_t zf = Tools::getBits(codes, ZF, ZF);
    int32_t sf = Tools::getBits(codes, SF, SF);
    int32_t of = Tools::getBits(codes, OF, OF);
-   std::cout << std::endl;
-   std::cout << "ZF: " << std::hex << std::setw(1) << zf << " ";
-   std::cout << "SF: " << std::hex << std::setw(1) << sf << " ";
-   std::cout << "OF: " << std::hex << std::setw(1) << of << std::endl;
+   out << std::endl;
+   out << "ZF: " << std::hex << std::setw(1) << zf << " ";
+   out << "SF: " << std::hex << std::setw(1) << sf << " ";
+   out << "OF: " << std::hex << std::setw(1) << of << std::endl;
 }
@@ -1,3 +1,4 @@
+#include <ostream>
 //The actual bits used within the codes register are
 //arbitrary. Use OF, SF, ZF in your code, not 3, 6, 2
 #define OF 3   //bit 3 of codes
@@ -7,13 +8,17 @@
 class ConditionCodes 
 {
    private:
-      static ConditionCodes * ccInstance;
+      static thread_local ConditionCodes * ccInstance;
       ConditionCodes();
       uint64_t codes;
    public:
       static ConditionCodes * getInstance();      
+      static ConditionCodes * create();
+      static void setInstance(ConditionCodes * instance);
       bool getConditionCode(int32_t ccNum, bool & error);
       void setConditionCode(bool value, int32_t ccNum, 
                             bool & error);
+      void reset();
       void dump();
+      static void dump(std::ostream & out, uint64_t codes);
 }; 
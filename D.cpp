@@ -23,6 +23,24 @@ D::D()
    rB = new PipeRegField(RNONE);
    valC = new PipeRegField();
    valP = new PipeRegField();
+   pc = new PipeRegField(NOPC);
+}
+
+/*
+ * D destructor
+ *
+ * frees the fields of the D pipeline register
+ */
+D::~D()
+{
+   delete stat;
+   delete icode;
+   delete ifun;
+   delete rA;
+   delete rB;
+   delete valC;
+   delete valP;
+   delete pc;
 }
 
 /* return the stat pipeline register */
@@ -67,18 +85,41 @@ PipeRegField * D::getvalP()
    return valP;
 }
 
+/* return the pc pipeline register */
+PipeRegField * D::getpc()
+{
+   return pc;
+}
+
 /* 
  * dump
  *
- * outputs the current values of the D pipeline register
+ * outputs the current values of the D pipeline register to out
+*/
+void D::dump(std::ostream & out)
+{
+   dumpField(out, "D: stat: ", 1, stat->getOutput(), false);
+   dumpField(out, " icode: ", 1, icode->getOutput(), false);
+   dumpField(out, " ifun: ", 1, ifun->getOutput(), false);
+   dumpField(out, " rA: ", 1, rA->getOutput(), false);
+   dumpField(out, " rB: ", 1, rB->getOutput(), false);
+   dumpField(out, " valC: ", 16, valC->getOutput(), false);
+   dumpField(out, " valP: ", 3, valP->getOutput(), true);
+}
+
+/*
+ * reset
+ *
+ * returns the D pipeline register to the values set by the constructor
 */
-void D::dump()
+void D::reset()
 {
-   dumpField("D: stat: ", 1, stat->getOutput(), false);
-   dumpField(" icode: ", 1, icode->getOutput(), false);
-   dumpField(" ifun: ", 1, ifun->getOutput(), false);
-   dumpField(" rA: ", 1, rA->getOutput(), false);
-   dumpField(" rB: ", 1, rB->getOutput(), false);
-   dumpField(" valC: ", 16, valC->getOutput(), false);
-   dumpField(" valP: ", 3, valP->getOutput(), true);
+   stat->bubble(SAOK);
+   icode->bubble(INOP);
+   ifun->bubble(FNONE);
+   rA->bubble(RNONE);
+   rB->bubble(RNONE);
+   valC->bubble();
+   valP->bubble();
+   pc->bubble(NOPC);
 }
@@ -9,8 +9,10 @@ class D : public PipeReg
       PipeRegField * rB;
       PipeRegField * valC;
       PipeRegField * valP;
+      PipeRegField * pc;    //address of the instruction; not dumped
    public:
       D();
+      ~D();
       PipeRegField * getstat();
       PipeRegField * geticode();
       PipeRegField * getifun();
@@ -18,5 +20,7 @@ class D : public PipeReg
       PipeRegField * getrB();
       PipeRegField * getvalC();
       PipeRegField * getvalP();
-      void dump();
+      PipeRegField * getpc();
+      void dump(std::ostream & out);
+      void reset();
 };
@@ -0,0 +1,89 @@
+#include <iostream>
+#include <string>
+#include <cstdint>
+#include "Debug.h"
+
+uint32_t Debug::mask = 0;
+std::atomic<uint64_t> Debug::counts[NUMTRACE];   //zeroed as statics are
+
+/*
+ * setMask
+ * sets the categories whose events are output
+ *
+ * @param mask - bit n set enables category n (TRACEFETCH, ...)
+ */
+void Debug::setMask(uint32_t mask)
+{
+   Debug::mask = mask;
+}
+
+/*
+ * parseMask
+ * converts a comma separated list of category names ("fetch,forward")
+ * or "all" to a mask
+ *
+ * @return false if a name is not a category
+ */
+bool Debug::parseMask(const char * names, uint32_t & mask)
+{
+   std::string list(names);
+   uint64_t start = 0;
+   mask = 0;
+   while (start <= list.length())
+   {
+      uint64_t end = list.find(',', start);
+      if (end == std::string::npos) end = list.length();
+      std::string word = list.substr(start, end - start);
+      int32_t category = 0;
+      while (category < NUMTRACE && word != name(category)) category++;
+      if (word == "all") mask |= (1 << NUMTRACE) - 1;
+      else if (category < NUMTRACE) mask |= 1 << category;
+      else return false;
+      start = end + 1;
+   }
+   return true;
+}
+
+/*
+ * count
+ * @return number of events of the category so far
+ */
+uint64_t Debug::count(int32_t category)
+{
+   return counts[category].load(std::memory_order_relaxed);
+}
+
+/*
+ * name
+ * @return name of the category ("fetch", "decode", ...)
+ */
+const char * Debug::name(int32_t category)
+{
+   static const char * names[NUMTRACE] = {
+      "fetch", "decode", "forward", "execute", "memory", "writeback",
+      "loader"
+   };
+   return names[category];
+}
+
+/*
+ * anyCompiled
+ * @return true if any category was compiled in
+ */
+bool Debug::anyCompiled()
+{
+   return TRACECOMPILED != 0;
+}
+
+/*
+ * dumpCounts
+ * outputs the number of events of each category that was compiled in
+ */
+void Debug::dumpCounts()
+{
+   std::cout << "trace events:";
+   for (int32_t i = 0; i < NUMTRACE; i++)
+      if ((TRACECOMPILED >> i) & 1)
+         std::cout << " " << name(i) << ": " << std::dec << count(i);
+   std::cout << std::endl;
+}
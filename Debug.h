@@ -1,4 +1,68 @@
+#include <cstdint>
+#include <atomic>
+#ifndef DEBUG_H
+#define DEBUG_H
 
-//global debug flag
-//use to output debugging information
-extern int debug;
+//trace categories; each is a bit in the compile-time and run-time masks
+#define TRACEFETCH 0
+#define TRACEDECODE 1
+#define TRACEFORWARD 2
+#define TRACEEXECUTE 3
+#define TRACEMEMORY 4
+#define TRACEWRITEBACK 5
+#define TRACELOADER 6
+#define NUMTRACE 7
+
+//categories compiled into the simulator (set by the YESS_TRACE cmake
+//option); the code of a category that is not in the mask is removed
+//by the compiler, so it costs nothing at run time
+#ifndef TRACECOMPILED
+#define TRACECOMPILED 0
+#endif
+
+//compile-time switch for one category
+template <int category>
+struct TraceCompiled
+{
+   static constexpr bool value = (TRACECOMPILED >> category) & 1;
+};
+
+//run-time category mask and per-category event counters. Use TRACE
+//rather than calling these directly: TRACE counts the event if the
+//category is compiled in and executes the statement (normally an
+//output to std::cout) only if the category is also in the mask.
+//The cores of a multicore run (-U) step on several threads, so the
+//counters are atomic; the increments need no ordering.
+class Debug
+{
+   private:
+      static uint32_t mask;
+      static std::atomic<uint64_t> counts[NUMTRACE];
+   public:
+      static void setMask(uint32_t mask);
+      static bool parseMask(const char * names, uint32_t & mask);
+      static uint64_t count(int32_t category);
+      static const char * name(int32_t category);
+      static bool anyCompiled();
+      static void dumpCounts();
+      template <int category> static bool event();
+};
+
+/*
+ * event
+ * counts an event of the category
+ *
+ * @return true if events of the category are to be output
+ */
+template <int category>
+inline bool Debug::event()
+{
+   counts[category].fetch_add(1, std::memory_order_relaxed);
+   return (mask >> category) & 1;
+}
+
+//counts and, if enabled, performs a trace statement of a category
+#define TRACE(category, statement) \
+   do { if (TraceCompiled<category>::value && Debug::event<category>()) \
+           { statement; } } while (0)
+#endif
@@ -1,3 +1,4 @@
+#include <iostream>
 #include <string>
 #include <cstdint>
 #include "Instructions.h"
@@ -10,11 +11,15 @@
 #include "M.h"
 #include "W.h"
 #include "Stage.h"
+#include "InstrTable.h"
 #include "ExecuteStage.h"
 #include "MemoryStage.h"
 #include "WritebackStage.h"
 #include "DecodeStage.h"
+#include "Forwarding.h"
 #include "Debug.h"
+#include "Memory.h"
+#include "Energy.h"
 
 
 
@@ -45,22 +50,40 @@ bool DecodeStage::doClockLow(PipeReg ** pregs, Stage ** stages)
     uint64_t rB = dreg->getrB()->getOutput();
     valC = dreg->getvalC()->getOutput();
     valP = dreg->getvalP()->getOutput();
-
-    uint64_t srcA = d_srcA(dreg, rA, icode);
-    uint64_t srcB = d_srcB(dreg, rB, icode);
-    uint64_t dstE = d_dstE(dreg, rB, icode);
-    uint64_t dstM = d_dstM(dreg, rA, icode);
-    valA = d_valA(srcA, icode, valP, executeStage, mreg, wreg, memoryStage);
-    valB = d_valB(srcB, executeStage, mreg, wreg, memoryStage);
+    const InstrProps & props = InstrTable::lookup(icode, ifun);
+
+    uint64_t srcA = d_srcA(props, rA, rB);
+    uint64_t srcB = d_srcB(props, rA, rB);
+    uint64_t dstE = d_dstE(props, rA, rB);
+    uint64_t dstM = d_dstM(props, rA, rB);
+    uint64_t pathA, pathB;
+    valA = d_valA(srcA, props, valP, executeStage, mreg, wreg, memoryStage, pathA);
+    valB = d_valB(srcB, executeStage, mreg, wreg, memoryStage, pathB);
+    Forwarding::getInstance()->operands(pathA, pathB);
+    if (Energy::isEnabled())
+    {
+        uint64_t paths[2] = {pathA, pathB};
+        for (int i = 0; i < 2; i++)
+        {
+            if (paths[i] == FWDREGFILE)
+                Energy::getInstance()->add(ENREGREAD, dreg->getpc()->getOutput());
+            else if (paths[i] < NUMFWDPATHS)
+                Energy::getInstance()->add(ENFORWARD, dreg->getpc()->getOutput());
+        }
+    }
+    TRACE(TRACEDECODE, std::cout << "decode: srcA " << std::hex << srcA
+          << " valA " << valA << " srcB " << srcB << " valB " << valB
+          << std::endl);
     
     setEInput(ereg, stat, icode, ifun, valC, valA, valB, dstE, dstM, srcA, srcB);
+    ereg->getpc()->setInput(dreg->getpc()->getOutput());
 
     return false;
 }
 
 /* doClockHigh
- * applies the appropriate control signal to the F
- * and D register intances
+ * applies the appropriate control signal to the E
+ * register instance
  *
  * @param: pregs - array of the pipeline register (F, D, E, M, W instances)
  */
@@ -68,6 +91,13 @@ void DecodeStage::doClockHigh(PipeReg ** pregs)
 {
     E *ereg = (E *)pregs[EREG];
 
+    if (Forwarding::getInstance()->isStalling())
+    {
+        //an operand is not available yet: send a bubble to E
+        ereg->reset();
+        return;
+    }
+
     ereg->getstat()->normal();
     ereg->geticode()->normal();
     ereg->getifun()->normal();
@@ -78,71 +108,55 @@ void DecodeStage::doClockHigh(PipeReg ** pregs)
     ereg->getdstM()->normal();
     ereg->getsrcA()->normal();
     ereg->getsrcB()->normal();
+    ereg->getpc()->normal();
 }
 
-uint64_t DecodeStage::d_srcA(D * dreg, uint64_t D_rA, uint64_t D_icode)
+/*
+ * d_srcA, d_srcB, d_dstE, d_dstM
+ * select the register id named by the instruction's table entry
+ * out of RNONE, rA, rB and RSP
+ *
+ * @param: props - table entry for the instruction in the D register
+ * @param: D_rA, D_rB - register fields of the D register
+ */
+uint64_t DecodeStage::d_srcA(const InstrProps & props, uint64_t D_rA, uint64_t D_rB)
 {
-    if (D_icode == IRRMOVQ || D_icode == IRMMOVQ || D_icode == IOPQ || D_icode == IPUSHQ)
-    {
-        return D_rA;
-    }
-    else if (D_icode == IPOPQ || D_icode == IRET)
-    {
-        return RSP;
-    }
-    else
-    {
-        return RNONE;
-    }
+    uint64_t regs[NUMREGSEL] = {RNONE, D_rA, D_rB, RSP, RBP};
+    return regs[props.srcA];
 }
 
-uint64_t DecodeStage::d_srcB(D * dreg, uint64_t D_rB, uint64_t D_icode)
+uint64_t DecodeStage::d_srcB(const InstrProps & props, uint64_t D_rA, uint64_t D_rB)
 {
-    if (D_icode == IOPQ || D_icode == IRMMOVQ || D_icode == IMRMOVQ)
-    {
-        return D_rB;
-    }
-    else if (D_icode == IPUSHQ || D_icode == IPOPQ || D_icode == ICALL || D_icode == IRET)
-    {
-        return RSP;
-    }
-    else
-    {
-        return RNONE;
-    }
+    uint64_t regs[NUMREGSEL] = {RNONE, D_rA, D_rB, RSP, RBP};
+    return regs[props.srcB];
 }
 
-uint64_t DecodeStage::d_dstE(D * dreg, uint64_t D_rB, uint64_t D_icode)
+uint64_t DecodeStage::d_dstE(const InstrProps & props, uint64_t D_rA, uint64_t D_rB)
 {
-    if (D_icode == IRRMOVQ || D_icode == IIRMOVQ || D_icode == IOPQ)
-    {
-        return D_rB;
-    }
-    else if (D_icode == IPUSHQ || D_icode == IPOPQ || D_icode == ICALL || D_icode == IRET)
-    {
-        return RSP;
-    }
-    else
-    {
-        return RNONE;
-    }
+    uint64_t regs[NUMREGSEL] = {RNONE, D_rA, D_rB, RSP, RBP};
+    return regs[props.dstE];
 }
 
-uint64_t DecodeStage::d_dstM(D * dreg, uint64_t D_rA, uint64_t D_icode)
+uint64_t DecodeStage::d_dstM(const InstrProps & props, uint64_t D_rA, uint64_t D_rB)
 {
-    if (D_icode == IMRMOVQ || D_icode == IPOPQ)
-    {
-        return D_rA;
-    }
-    else
-    {
-        return RNONE;
-    }
+    uint64_t regs[NUMREGSEL] = {RNONE, D_rA, D_rB, RSP, RBP};
+    return regs[props.dstM];
 }
 
-uint64_t DecodeStage::d_valA(uint64_t d_srcA, uint64_t D_icode, uint64_t D_valP, ExecuteStage *executeStage, M *mreg, W *wreg, MemoryStage *memoryStage)
+/*
+ * d_valA, d_valB
+ * select the value of an operand: valP for jXX and call, 0 for RNONE,
+ * and otherwise the value forwarded by the youngest producer of the
+ * register or the register file
+ *
+ * @param: d_srcA, d_srcB - register read by the operand
+ * @param: path - set to the source of the value (FWDEVALE, ...,
+ *         FWDREGFILE or FWDNONE)
+ */
+uint64_t DecodeStage::d_valA(uint64_t d_srcA, const InstrProps & props, uint64_t D_valP, ExecuteStage *executeStage, M *mreg, W *wreg, MemoryStage *memoryStage, uint64_t & path)
 {
-    if (D_icode == ICALL || D_icode == IJXX)
+    path = FWDNONE;
+    if (props.selValP)
     {
         return D_valP;
     }
@@ -152,86 +166,57 @@ uint64_t DecodeStage::d_valA(uint64_t d_srcA, uint64_t D_icode, uint64_t D_valP,
         return 0;
     }
 
-    uint64_t e_dstE = executeStage->gete_dstE();
-    uint64_t e_valE = executeStage->gete_valE();
-    uint64_t M_dstE = mreg->getdstE()->getOutput();
-    uint64_t M_valE = mreg->getvalE()->getOutput();
-    uint64_t M_dstM = mreg->getdstM()->getOutput();
-    uint64_t W_dstE = wreg->getdstE()->getOutput();
-    uint64_t W_valE = wreg->getvalE()->getOutput();
-    uint64_t W_dstM = wreg->getdstM()->getOutput();
-    uint64_t W_valM = wreg->getvalM()->getOutput();
-    uint64_t m_valM = memoryStage->getvalM();
-    if (d_srcA == e_dstE)
-    {
-        return e_valE;
-    }
-    else if (d_srcA == M_dstM)
-    {
-        return m_valM;
-    }
-    else if (d_srcA == M_dstE)
-    {
-        return M_valE;
-    }
-    else if (d_srcA == W_dstM)
-    {
-        return W_valM;
-    }
-    else if (d_srcA == W_dstE)
-    {
-        return W_valE;
-    }
-    else
-    {
-        bool error = false;
-        return RegisterFile::getInstance()->readRegister(d_srcA, error);
-    }
+    return forward(d_srcA, "srcA", executeStage, mreg, wreg, memoryStage, path);
 }
 
-uint64_t DecodeStage::d_valB(uint64_t d_srcB, ExecuteStage *executeStage, M *mreg, W *wreg, MemoryStage *memoryStage)
+uint64_t DecodeStage::d_valB(uint64_t d_srcB, ExecuteStage *executeStage, M *mreg, W *wreg, MemoryStage *memoryStage, uint64_t & path)
 {
+    path = FWDNONE;
     if (d_srcB == RNONE)
     {
         return 0;
     }
 
-    uint64_t e_dstE = executeStage->gete_dstE();
-    uint64_t e_valE = executeStage->gete_valE();
-    uint64_t M_dstE = mreg->getdstE()->getOutput();
-    uint64_t M_valE = mreg->getvalE()->getOutput();
-    uint64_t M_dstM = mreg->getdstM()->getOutput();
-    uint64_t W_dstE = wreg->getdstE()->getOutput();
-    uint64_t W_valE = wreg->getvalE()->getOutput();
-    uint64_t W_dstM = wreg->getdstM()->getOutput();
-    uint64_t W_valM = wreg->getvalM()->getOutput();
-    uint64_t m_valM = memoryStage->getvalM();
+    return forward(d_srcB, "srcB", executeStage, mreg, wreg, memoryStage, path);
+}
 
-    if (d_srcB == e_dstE)
-    {
-        return e_valE;
-    }
-    else if (d_srcB == M_dstM)
-    {
-        return m_valM;
-    }
-    else if (d_srcB == M_dstE)
-    {
-        return M_valE;
-    }
-    else if (d_srcB == W_dstM)
-    {
-        return W_valM;
-    }
-    else if (d_srcB == W_dstE)
-    {
-        return W_valE;
-    }
-    else
-    {
-        bool error = false;
-        return RegisterFile::getInstance()->readRegister(d_srcB, error); 
-    }
+/*
+ * forward
+ * returns the value of register d_src from the first forwarding path,
+ * in priority order, whose destination is d_src, or from the register
+ * file if there is none. If that path is disabled the value is not
+ * available yet and the stage stalls (see Forwarding::operands).
+ *
+ * @param: d_src - register to read
+ * @param: operand - "srcA" or "srcB", for the trace
+ * @param: path - set to the path that matched or FWDREGFILE
+ */
+uint64_t DecodeStage::forward(uint64_t d_src, const char * operand, ExecuteStage *executeStage, M *mreg, W *wreg, MemoryStage *memoryStage, uint64_t & path)
+{
+    uint64_t dst[NUMFWDPATHS] = {executeStage->gete_dstE(),
+                                 mreg->getdstM()->getOutput(),
+                                 mreg->getdstE()->getOutput(),
+                                 wreg->getdstM()->getOutput(),
+                                 wreg->getdstE()->getOutput()};
+    uint64_t val[NUMFWDPATHS] = {executeStage->gete_valE(),
+                                 memoryStage->getvalM(),
+                                 mreg->getvalE()->getOutput(),
+                                 wreg->getvalM()->getOutput(),
+                                 wreg->getvalE()->getOutput()};
+
+    for (path = 0; path < NUMFWDPATHS; path++)
+    {
+        if (d_src == dst[path])
+        {
+            TRACE(TRACEFORWARD, std::cout << "forward: " << operand << " "
+                  << std::hex << d_src << " from "
+                  << Forwarding::name(path) << std::endl);
+            return val[path];
+        }
+    }
+
+    bool error = false;
+    return RegisterFile::getInstance()->readRegister(d_src, error);
 }
 
 /* setInput
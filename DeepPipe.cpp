@@ -0,0 +1,218 @@
+#include <iostream>
+#include <iomanip>
+#include <cstdint>
+#include <vector>
+#include "Memory.h"
+#include "RegisterFile.h"
+#include "Instructions.h"
+#include "Status.h"
+#include "Executor.h"
+#include "InstrTrace.h"
+#include "DeepPipe.h"
+
+/*
+ * DeepPipe constructor
+ *
+ * @param config - sub-stages of fetch, execute and memory; see valid
+ */
+DeepPipe::DeepPipe(const DeepConfig & config)
+{
+   this->config = config;
+   decode = config.fetch;
+   lastExecute = decode + config.execute;
+   lastMemory = lastExecute + config.memory;
+   depth = lastMemory + 2;
+   started = false;
+   for (uint64_t i = 0; i <= EXECCCREG; i++)
+   {
+      ready[i] = 0;
+      loaded[i] = false;
+   }
+   fetchReady = 0;
+   fetchReason = -1;
+   instructions = 0;
+   cycles = 0;
+   for (int32_t i = 0; i < NUMDEEPSTALLS; i++) events[i] = stalls[i] = 0;
+}
+
+/*
+ * valid
+ * @return true if fetch, execute and memory each have 1 to
+ *         MAXSUBSTAGES sub-stages
+ */
+bool DeepPipe::valid(const DeepConfig & config)
+{
+   return config.fetch > 0 && config.fetch <= MAXSUBSTAGES &&
+          config.execute > 0 && config.execute <= MAXSUBSTAGES &&
+          config.memory > 0 && config.memory <= MAXSUBSTAGES;
+}
+
+/*
+ * run
+ * executes the program in Memory from address 0 until a halt or an
+ * instruction with an error status, adding every instruction to each
+ * of the pipes, so any number of configurations are timed by one
+ * execution of the program
+ */
+void DeepPipe::run(std::vector<DeepPipe *> & pipes)
+{
+   Executor executor;
+   InstrRecord r;
+   do
+   {
+      executor.step(r);
+      for (uint64_t i = 0; i < pipes.size(); i++) pipes[i]->add(r);
+   } while (r.stat == SAOK);
+}
+
+/*
+ * replay
+ * adds every instruction of the trace in fileName (written by
+ * InstrTrace::record) to each of the pipes without executing the
+ * program, so each configuration only costs its timing
+ *
+ * @return false if the file is not a trace or ends before an
+ *         instruction with a status other than SAOK
+ */
+bool DeepPipe::replay(std::vector<DeepPipe *> & pipes, const char * fileName)
+{
+   InstrTrace trace;
+   InstrRecord r;
+   if (!trace.open(fileName)) return false;
+   do
+   {
+      if (!trace.next(r)) return false;
+      for (uint64_t i = 0; i < pipes.size(); i++) pipes[i]->add(r);
+   } while (r.stat == SAOK);
+   return true;
+}
+
+/*
+ * add
+ * moves the next instruction of the program through the sub-stages,
+ * each as early as the instruction ahead of it, its operands and the
+ * fetch redirections allow. The instruction ahead must have left a
+ * sub-stage (entered the next one) before this one enters it.
+ *
+ * @param r - the instruction, as described by Executor::step
+ */
+void DeepPipe::add(const InstrRecord & r)
+{
+   uint64_t t[MAXDEPTH];   //cycle in which the instruction enters each sub-stage
+
+   t[0] = started ? prev[1] : 0;
+   if (fetchReason >= 0 && fetchReady > t[0])
+   {
+      stalls[fetchReason] += fetchReady - t[0];
+      t[0] = fetchReady;
+   }
+   for (uint64_t s = 1; s < depth; s++)
+   {
+      t[s] = t[s - 1] + 1;
+      if (started)
+      {
+         uint64_t free = s + 1 < depth ? prev[s + 1] : prev[s] + 1;
+         if (free > t[s]) t[s] = free;
+      }
+      if (s == decode + 1)
+      {
+         //the operands have to be forwarded to the first execute sub-stage
+         uint64_t operand = 0;
+         bool load = false;
+         for (uint64_t i = 0; i < r.numRegs; i++)
+         {
+            if (ready[r.reg[i]] > operand)
+            {
+               operand = ready[r.reg[i]];
+               load = loaded[r.reg[i]];
+            }
+         }
+         if (operand > t[s])
+         {
+            int32_t reason = load ? DEEPLOADUSE : DEEPALUUSE;
+            events[reason]++;
+            stalls[reason] += operand - t[s];
+            t[s] = operand;
+         }
+      }
+   }
+
+   for (uint64_t i = 0; i < r.numDests; i++)
+   {
+      ready[r.dest[i]] = t[lastExecute] + 1;
+      loaded[r.dest[i]] = false;
+   }
+   if (r.loaded != RNONE)
+   {
+      ready[r.loaded] = t[lastMemory] + 1;
+      loaded[r.loaded] = true;
+   }
+
+   fetchReason = -1;
+   if (r.redirect && r.icode == IRET)
+   {
+      fetchReason = DEEPRET;
+      fetchReady = t[lastMemory] + 1;
+   }
+   else if (r.redirect)
+   {
+      fetchReason = DEEPMISPREDICT;
+      fetchReady = t[lastExecute] + 1;
+   }
+   else if (r.taken)
+   {
+      fetchReason = DEEPTAKEN;
+      fetchReady = t[decode - 1] + 1;
+   }
+   if (fetchReason >= 0) events[fetchReason]++;
+
+   if (r.stat == SAOK || r.stat == SHLT) instructions++;
+   cycles = t[depth - 1] + 1;
+   for (uint64_t s = 0; s < depth; s++) prev[s] = t[s];
+   started = true;
+}
+
+/*
+ * getCycles
+ * @return cycles until the last instruction added left writeback
+ */
+uint64_t DeepPipe::getCycles()
+{
+   return cycles;
+}
+
+/*
+ * getInstructions
+ * @return number of instructions added, not counting one with an
+ *         error status
+ */
+uint64_t DeepPipe::getInstructions()
+{
+   return instructions;
+}
+
+/*
+ * dump
+ * outputs the configuration, the CPI and, for each reason an
+ * instruction can wait, the instructions that caused a wait and the
+ * cycles lost
+ */
+void DeepPipe::dump()
+{
+   static const char * names[NUMDEEPSTALLS] = {"mispredicted jXX", "ret",
+                                               "taken", "load-use", "alu-use"};
+   std::cout << std::dec << "\nPipeline with " << config.fetch << " fetch, "
+             << config.execute << " execute and " << config.memory
+             << " memory sub-stages (depth " << depth << "):" << std::endl;
+   std::cout << "instructions: " << instructions << " cycles: " << cycles
+             << " CPI: " << (double) cycles / instructions << std::endl;
+   for (int32_t i = 0; i < NUMDEEPSTALLS; i++)
+   {
+      std::cout << std::setw(16) << names[i] << ": " << std::setw(8)
+                << events[i] << " penalty " << std::setw(8) << stalls[i]
+                << " cycles";
+      if (events[i] > 0)
+         std::cout << " (" << (double) stalls[i] / events[i] << " each)";
+      std::cout << std::endl;
+   }
+}
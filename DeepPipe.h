@@ -0,0 +1,70 @@
+#include <cstdint>
+#include <vector>
+#include "Executor.h"
+#ifndef DEEPPIPE_H
+#define DEEPPIPE_H
+
+//most sub-stages the fetch, execute or memory stage can be split into
+#define MAXSUBSTAGES 8
+//decode and writeback are never split
+#define MAXDEPTH (3 * MAXSUBSTAGES + 2)
+
+//reasons an instruction enters a stage later than the instruction
+//ahead of it allows
+#define DEEPMISPREDICT 0   //fetch waits for a not taken jXX to execute
+#define DEEPRET 1          //fetch waits for a ret to read its address
+#define DEEPTAKEN 2        //fetch waits for the target of a jmp, call or jXX
+#define DEEPLOADUSE 3      //an operand waits for the memory stages
+#define DEEPALUUSE 4       //an operand waits for the execute stages
+#define NUMDEEPSTALLS 5
+
+//number of sub-stages of each stage that can be split
+struct DeepConfig
+{
+   uint64_t fetch;
+   uint64_t execute;
+   uint64_t memory;
+};
+
+//timing model of a scalar in-order PIPE whose fetch, execute and memory
+//stages are each split into sub-stages with a pipeline register after
+//each one. Results are forwarded from the end of the last execute
+//sub-stage (and from the end of the last memory sub-stage for a word
+//read from memory) to the start of the first execute sub-stage, so an
+//operand that is not ready holds the instruction in decode. jXX is
+//predicted taken; the target of a jmp, call or jXX is known at the end
+//of the last fetch sub-stage, a not taken jXX is resolved at the end
+//of the last execute sub-stage and the address of a ret at the end of
+//the last memory sub-stage. The instructions come from an Executor or
+//an InstrTrace, in program order.
+class DeepPipe
+{
+   private:
+      DeepConfig config;
+      uint64_t depth;                    //sub-stages from fetch to writeback
+      uint64_t decode;                   //index of the decode stage
+      uint64_t lastExecute;              //index of the last execute sub-stage
+      uint64_t lastMemory;               //index of the last memory sub-stage
+      uint64_t prev[MAXDEPTH];           //cycles the previous instruction
+                                         //entered each sub-stage
+      bool started;                      //an instruction has been added
+      uint64_t ready[EXECCCREG + 1];     //first cycle each register or the
+                                         //condition codes can enter execute
+      bool loaded[EXECCCREG + 1];        //the value comes from memory
+      uint64_t fetchReady;               //first cycle of the next fetch
+      int32_t fetchReason;               //DEEPMISPREDICT, ... or -1
+      uint64_t instructions;
+      uint64_t cycles;                   //cycles until the last writeback
+      uint64_t events[NUMDEEPSTALLS];    //instructions that waited
+      uint64_t stalls[NUMDEEPSTALLS];    //cycles they waited
+   public:
+      DeepPipe(const DeepConfig & config);
+      static bool valid(const DeepConfig & config);
+      static void run(std::vector<DeepPipe *> & pipes);
+      static bool replay(std::vector<DeepPipe *> & pipes, const char * fileName);
+      void add(const InstrRecord & r);
+      uint64_t getCycles();
+      uint64_t getInstructions();
+      void dump();
+};
+#endif
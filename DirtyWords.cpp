@@ -0,0 +1,48 @@
+#include <cstdint>
+#include <vector>
+#include "Memory.h"
+#include "Tools.h"
+#include "DirtyWords.h"
+
+/*
+ * DirtyWords constructor
+ */
+DirtyWords::DirtyWords()
+{
+   for (int32_t i = 0; i < MEMWORDS; i++) dirty[i] = false;
+}
+
+/*
+ * memoryWritten
+ * called by the Memory when length bytes at address are written;
+ * marks the words holding them
+ */
+void DirtyWords::memoryWritten(int32_t address, int32_t length)
+{
+   for (int32_t i = address / LONGSIZE;
+        i <= (address + length - 1) / LONGSIZE && i < MEMWORDS; i++)
+   {
+      if (!dirty[i]) words.push_back(i);
+      dirty[i] = true;
+   }
+}
+
+/*
+ * getWords
+ * @return the numbers (address / LONGSIZE) of the words stored to
+ *         since the last clear, each once
+ */
+const std::vector<uint64_t> & DirtyWords::getWords()
+{
+   return words;
+}
+
+/*
+ * clear
+ * forgets the words stored to so far
+ */
+void DirtyWords::clear()
+{
+   for (uint64_t i = 0; i < words.size(); i++) dirty[words[i]] = false;
+   words.clear();
+}
@@ -0,0 +1,25 @@
+#include <cstdint>
+#include <vector>
+#include "Tools.h"
+#include "Memory.h"
+#ifndef DIRTYWORDS_H
+#define DIRTYWORDS_H
+
+//number of 64-bit memory words
+#define MEMWORDS (MEMSIZE / LONGSIZE)
+
+//the memory words stored to since the last clear. A tool that reads
+//only the words that changed in a cycle (the ReplayLog, the
+//Fingerprint) adds one as an observer of the Memory while it runs.
+class DirtyWords : public MemoryObserver
+{
+   private:
+      bool dirty[MEMWORDS];          //true if the word is in words
+      std::vector<uint64_t> words;   //words stored to, in store order
+   public:
+      DirtyWords();
+      void memoryWritten(int32_t address, int32_t length);
+      const std::vector<uint64_t> & getWords();
+      void clear();
+};
+#endif
@@ -26,6 +26,27 @@ E::E()
    dstM = new PipeRegField(RNONE);
    srcA = new PipeRegField();
    srcB = new PipeRegField();
+   pc = new PipeRegField(NOPC);
+}
+
+/*
+ * E destructor
+ *
+ * frees the fields of the E pipeline register
+ */
+E::~E()
+{
+   delete stat;
+   delete icode;
+   delete ifun;
+   delete valC;
+   delete valA;
+   delete valB;
+   delete dstE;
+   delete dstM;
+   delete srcA;
+   delete srcB;
+   delete pc;
 }
 
 /* return the stat pipeline register field */
@@ -89,21 +110,47 @@ PipeRegField * E::getsrcB()
    return srcB;
 }
 
+/* return the pc pipeline register field */
+PipeRegField * E::getpc()
+{
+   return pc;
+}
+
 /* 
  * dump
  *
- * outputs the current values of the E pipeline register
+ * outputs the current values of the E pipeline register to out
+*/
+void E::dump(std::ostream & out)
+{
+   dumpField(out, "E: stat: ", 1, stat->getOutput(), false);
+   dumpField(out, " icode: ", 1, icode->getOutput(), false);
+   dumpField(out, " ifun: ", 1, ifun->getOutput(), false);
+   dumpField(out, " valC: ", 16, valC->getOutput(), false);
+   dumpField(out, " valA: ", 16, valA->getOutput(), true);
+   dumpField(out, "E: valB: ", 16, valB->getOutput(), false);
+   dumpField(out, " dstE: ", 1, dstE->getOutput(), false);
+   dumpField(out, " dstM: ", 1, dstM->getOutput(), false);
+   dumpField(out, " srcA: ", 1, srcA->getOutput(), false);
+   dumpField(out, " srcB: ", 1, srcB->getOutput(), true);
+}
+
+/*
+ * reset
+ *
+ * returns the E pipeline register to the values set by the constructor
 */
-void E::dump()
+void E::reset()
 {
-   dumpField("E: stat: ", 1, stat->getOutput(), false);
-   dumpField(" icode: ", 1, icode->getOutput(), false);
-   dumpField(" ifun: ", 1, ifun->getOutput(), false);
-   dumpField(" valC: ", 16, valC->getOutput(), false);
-   dumpField(" valA: ", 16, valA->getOutput(), true);
-   dumpField("E: valB: ", 16, valB->getOutput(), false);
-   dumpField(" dstE: ", 1, dstE->getOutput(), false);
-   dumpField(" dstM: ", 1, dstM->getOutput(), false);
-   dumpField(" srcA: ", 1, srcA->getOutput(), false);
-   dumpField(" srcB: ", 1, srcB->getOutput(), true);
+   stat->bubble(SAOK);
+   icode->bubble(INOP);
+   ifun->bubble(FNONE);
+   valC->bubble();
+   valA->bubble();
+   valB->bubble();
+   dstE->bubble(RNONE);
+   dstM->bubble(RNONE);
+   srcA->bubble();
+   srcB->bubble();
+   pc->bubble(NOPC);
 }
@@ -12,8 +12,10 @@ class E : public PipeReg
       PipeRegField * dstM;
       PipeRegField * srcA;
       PipeRegField * srcB;
+      PipeRegField * pc;    //address of the instruction; not dumped
    public:
       E();
+      ~E();
       PipeRegField * getstat();
       PipeRegField * geticode();
       PipeRegField * getifun();
@@ -24,5 +26,7 @@ class E : public PipeReg
       PipeRegField * getdstM();
       PipeRegField * getsrcA();
       PipeRegField * getsrcB();
-      void dump();
+      PipeRegField * getpc();
+      void dump(std::ostream & out);
+      void reset();
 };
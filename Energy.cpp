@@ -0,0 +1,247 @@
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <cstdint>
+#include <map>
+#include "Memory.h"
+#include "Tools.h"
+#include "RegisterFile.h"
+#include "PipeRegField.h"
+#include "PipeReg.h"
+#include "D.h"
+#include "E.h"
+#include "M.h"
+#include "W.h"
+#include "ReplayLog.h"
+#include "Energy.h"
+
+Energy * Energy::energyInstance = NULL;
+bool Energy::enabled = false;
+
+/*
+ * Energy constructor
+ * starts with no events and the default table, in pJ per event
+ */
+Energy::Energy()
+{
+   static const double defaults[NUMENERGY] = {
+      8.0,     //fetch
+      1.5,     //regread
+      0.3,     //forward
+      2.0,     //alu
+      12.0,    //muldiv
+      0.2,     //ccwrite
+      10.0,    //memread
+      11.0,    //memwrite
+      1.8,     //regwrite
+      0.02,    //toggle
+      5.0      //cycle
+   };
+   for (int32_t i = 0; i < NUMENERGY; i++)
+   {
+      table[i] = defaults[i];
+      counts[i] = 0;
+   }
+   for (int32_t i = 0; i < NUMPIPEREGS; i++) toggles[i] = 0;
+   mhz = ENERGYMHZ;
+   cycles = 0;
+   bound = false;
+}
+
+/*
+ * getInstance
+ * if energyInstance is NULL then creates an Energy object
+ * and sets energyInstance to point to it; returns energyInstance
+ *
+ * @return energyInstance
+ */
+Energy * Energy::getInstance()
+{
+   if (energyInstance == NULL)
+   {
+      energyInstance = new Energy();
+   }
+   return energyInstance;
+}
+
+/*
+ * setEnabled
+ * @param enabled - true if the stages report their events from now on
+ */
+void Energy::setEnabled(bool enabled)
+{
+   Energy::enabled = enabled;
+}
+
+/*
+ * name
+ * @return name of the event in the energy table ("fetch", ...)
+ */
+const char * Energy::name(int32_t event)
+{
+   static const char * names[NUMENERGY] = {
+      "fetch", "regread", "forward", "alu", "muldiv", "ccwrite",
+      "memread", "memwrite", "regwrite", "toggle", "cycle"
+   };
+   return names[event];
+}
+
+/*
+ * loadTable
+ * reads an energy table: lines of an event name and its energy in pJ
+ * ("memread 12.5") or "mhz" and the clock frequency; text after a #
+ * is ignored and events that are not listed keep their defaults
+ *
+ * @return false if the file cannot be read or a line is not valid
+ */
+bool Energy::loadTable(const char * fileName)
+{
+   std::ifstream in(fileName);
+   if (!in.is_open()) return false;
+   std::string line;
+   while (getline(in, line))
+   {
+      std::string::size_type hash = line.find('#');
+      if (hash != std::string::npos) line.erase(hash);
+      std::istringstream words(line);
+      std::string word;
+      double value;
+      if (!(words >> word)) continue;
+      if (!(words >> value) || value < 0) return false;
+      int32_t event = 0;
+      while (event < NUMENERGY && word != name(event)) event++;
+      if (word == "mhz" && value > 0) mhz = value;
+      else if (event < NUMENERGY) table[event] = value;
+      else return false;
+   }
+   return true;
+}
+
+/*
+ * pcCounts
+ * @return the event counts of the instruction at pc, creating them
+ *         the first time
+ */
+uint64_t * Energy::pcCounts(uint64_t pc)
+{
+   std::map<uint64_t, uint64_t *>::iterator it = pcs.find(pc);
+   if (it != pcs.end()) return it->second;
+   uint64_t * events = new uint64_t[NUMENERGY]();
+   pcs[pc] = events;
+   return events;
+}
+
+/*
+ * add
+ * counts an event of the instruction at pc
+ *
+ * @param event - ENFETCH, ..., ENREGWRITE
+ * @param pc - address of the instruction, NOPC for a bubble
+ */
+void Energy::add(int32_t event, uint64_t pc)
+{
+   counts[event]++;
+   pcCounts(pc)[event]++;
+}
+
+/*
+ * bind
+ * starts counting toggles from the current contents of the pipeline
+ * registers pregs
+ */
+void Energy::bind(PipeReg * pregs[])
+{
+   ReplayLog::bindFields(pregs, fields);
+   for (int32_t i = 0; i < NUMFIELDS; i++) last[i] = fields[i]->getOutput();
+   bound = true;
+}
+
+/*
+ * clocked
+ * called after the pipeline registers are updated at the end of each
+ * cycle; counts the bits of each register that changed, charging them
+ * to the instruction it now holds, and the cycle
+ */
+void Energy::clocked(PipeReg ** pregs)
+{
+   if (!bound) bind(pregs);
+   //F has no pc; its bits are charged with the cycle
+   uint64_t pc[NUMPIPEREGS] = {NOPC,
+                               ((D *) pregs[DREG])->getpc()->getOutput(),
+                               ((E *) pregs[EREG])->getpc()->getOutput(),
+                               ((M *) pregs[MREG])->getpc()->getOutput(),
+                               ((W *) pregs[WREG])->getpc()->getOutput()};
+   int32_t field = 0;
+   for (int32_t reg = 0; reg < NUMPIPEREGS; reg++)
+   {
+      uint64_t bits = 0;
+      for (int32_t i = 0; i < ReplayLog::numFields[reg]; i++, field++)
+      {
+         uint64_t value = fields[field]->getOutput();
+         bits += Tools::popCount(value ^ last[field]);
+         last[field] = value;
+      }
+      toggles[reg] += bits;
+      counts[ENTOGGLE] += bits;
+      pcCounts(pc[reg])[ENTOGGLE] += bits;
+   }
+   add(ENCYCLE, NOPC);
+   cycles++;
+}
+
+/*
+ * energy
+ * @return pJ used by the events
+ */
+double Energy::energy(const uint64_t events[NUMENERGY])
+{
+   double total = 0;
+   for (int32_t i = 0; i < NUMENERGY; i++) total += events[i] * table[i];
+   return total;
+}
+
+/*
+ * dump
+ * outputs the count and energy of each event, the bits toggled in each
+ * pipeline register, the total energy and the average power at the
+ * clock frequency, then the energy of each instruction address
+ */
+void Energy::dump()
+{
+   static const char * regs[NUMPIPEREGS] = {"F", "D", "E", "M", "W"};
+   double total = energy(counts);
+   if (cycles == 0 || total == 0) return;
+   double seconds = cycles / (mhz * 1e6);
+
+   std::cout << std::dec << "\nEnergy (" << cycles << " cycles at " << mhz
+             << " MHz):" << std::endl;
+   std::cout << "   event      count         pJ       %" << std::endl;
+   std::cout << std::fixed << std::setprecision(1);
+   for (int32_t i = 0; i < NUMENERGY; i++)
+      std::cout << std::setw(8) << name(i) << " " << std::setw(10) << counts[i]
+                << " " << std::setw(10) << counts[i] * table[i] << " "
+                << std::setw(6) << 100.0 * counts[i] * table[i] / total
+                << "%" << std::endl;
+   std::cout << "toggled bits:";
+   for (int32_t i = 0; i < NUMPIPEREGS; i++)
+      std::cout << " " << regs[i] << " " << toggles[i];
+   std::cout << std::endl << std::setprecision(3) << "total: " << total / 1000
+             << " nJ average power: " << total * 1e-9 / seconds << " mW"
+             << std::endl;
+
+   std::cout << std::setprecision(1) << "\n pc:         pJ       %" << std::endl;
+   std::map<uint64_t, uint64_t *>::iterator it;
+   for (it = pcs.begin(); it != pcs.end(); it++)
+   {
+      double pJ = energy(it->second);
+      if (it->first == NOPC) std::cout << "  -";
+      else std::cout << std::hex << std::setw(3) << std::setfill('0')
+                     << it->first << std::dec << std::setfill(' ');
+      std::cout << ": " << std::setw(10) << pJ << " " << std::setw(6)
+                << 100.0 * pJ / total << "%" << std::endl;
+   }
+   std::cout.unsetf(std::ios::floatfield);
+   std::cout << std::setprecision(6);
+}
@@ -0,0 +1,67 @@
+#include <cstdint>
+#include <map>
+#ifndef ENERGY_H
+#define ENERGY_H
+
+//events that cost energy, each with an entry in the energy table
+#define ENFETCH 0      //instruction fetched
+#define ENREGREAD 1    //operand read from the register file
+#define ENFORWARD 2    //operand taken from a forwarding path
+#define ENALU 3        //ALU operation (add, sub, and, xor, shifts)
+#define ENMULDIV 4     //mulq, divq or modq
+#define ENCCWRITE 5    //condition codes set
+#define ENMEMREAD 6    //word read from memory
+#define ENMEMWRITE 7   //word written to memory
+#define ENREGWRITE 8   //register written
+#define ENTOGGLE 9     //pipeline register bit that changed at a clock edge
+#define ENCYCLE 10     //clock distribution and leakage of one cycle
+#define NUMENERGY 11
+
+//default clock frequency in MHz, used for the average power
+#define ENERGYMHZ 1000
+
+class PipeReg;
+class PipeRegField;
+
+//activity counts of the structures of the pipeline, in total and for
+//each instruction address, and an energy table in picojoules per
+//event that turns them into an energy and average power estimate.
+//The stages only report events while it is enabled.
+class Energy
+{
+   private:
+      static Energy * energyInstance;
+      static bool enabled;
+      Energy();
+      double table[NUMENERGY];             //pJ per event
+      double mhz;
+      uint64_t counts[NUMENERGY];
+      uint64_t toggles[NUMPIPEREGS];       //bits changed in each register
+      uint64_t cycles;
+      std::map<uint64_t, uint64_t *> pcs;  //counts of each address (or NOPC)
+      PipeRegField * fields[NUMFIELDS];
+      uint64_t last[NUMFIELDS];            //fields after the last clock edge
+      bool bound;
+      uint64_t * pcCounts(uint64_t pc);
+      double energy(const uint64_t events[NUMENERGY]);
+   public:
+      static Energy * getInstance();
+      static void setEnabled(bool enabled);
+      static bool isEnabled();
+      static const char * name(int32_t event);
+      bool loadTable(const char * fileName);
+      void bind(PipeReg * pregs[]);
+      void add(int32_t event, uint64_t pc);
+      void clocked(PipeReg ** pregs);
+      void dump();
+};
+
+/*
+ * isEnabled
+ * @return true if the stages report their events
+ */
+inline bool Energy::isEnabled()
+{
+   return enabled;
+}
+#endif
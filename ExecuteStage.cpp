@@ -1,3 +1,4 @@
+#include <iostream>
 #include <string>
 #include <cstdint>
 #include "RegisterFile.h"
@@ -9,12 +10,15 @@
 #include "M.h"
 #include "W.h"
 #include "Stage.h"
+#include "InstrTable.h"
 #include "ExecuteStage.h"
 #include "Status.h"
 #include "Debug.h"
 #include "Instructions.h"
 #include "ConditionCodes.h"
 #include "Tools.h"
+#include "Memory.h"
+#include "Energy.h"
 
 /*
  * doClockLow:
@@ -37,23 +41,36 @@ bool ExecuteStage::doClockLow(PipeReg **pregs, Stage **stages)
    uint64_t valB = ereg->getvalB()->getOutput();
    uint64_t dstE = ereg->getdstE()->getOutput();
    uint64_t dstM = ereg->getdstM()->getOutput();
+   const InstrProps & props = InstrTable::lookup(icode, ifun);
 
-   uint64_t val_aluA = aluA(icode, valA, valC);
-   uint64_t val_aluB = aluB(icode, valB);
-   uint64_t val_alufun = alufun(icode, ifun);
+   uint64_t val_aluA = aluA(props, valA, valC);
+   uint64_t val_aluB = aluB(props, valB);
+   uint64_t val_alufun = alufun(props);
    uint64_t valE = alu(val_aluA, val_aluB, val_alufun);
 
-   cc(icode, valE, val_aluA, val_aluB, val_alufun);
+   cc(props, valE, val_aluA, val_aluB, val_alufun);
+   if (Energy::isEnabled())
+   {
+      uint64_t pc = ereg->getpc()->getOutput();
+      if (props.aluA != ALUAZERO || props.aluB != ALUBZERO)
+         Energy::getInstance()->add(val_alufun >= MULQ && val_alufun <= MODQ ?
+                                    ENMULDIV : ENALU, pc);
+      if (set_cc(props)) Energy::getInstance()->add(ENCCWRITE, pc);
+   }
 
    uint64_t e_Cnd = 0;
-   e_Cnd = cond(icode, ifun);
+   e_Cnd = cond(props, ifun);
 
    e_dstE_ = e_dstE(icode, e_Cnd, dstE);
    e_valE_ = valE;
+   TRACE(TRACEEXECUTE, std::cout << "execute: aluA " << std::hex << val_aluA
+         << " aluB " << val_aluB << " alufun " << val_alufun << " valE "
+         << valE << " Cnd " << e_Cnd << std::endl);
 
    uint64_t stat = ereg->getstat()->getOutput();
    
    setMInput(mreg, stat, icode, e_Cnd, valE, valA, e_dstE_, dstM);
+   mreg->getpc()->setInput(ereg->getpc()->getOutput());
 
    return false;
 }
@@ -68,68 +85,26 @@ uint64_t ExecuteStage::gete_valE()
    return e_valE_;
 }
 
-uint64_t ExecuteStage::aluA(uint64_t E_icode, uint64_t E_valA, uint64_t E_valC)
+uint64_t ExecuteStage::aluA(const InstrProps & props, uint64_t E_valA, uint64_t E_valC)
 {
-   if (E_icode == IRRMOVQ || E_icode == IOPQ)
-   {
-      return E_valA;
-   }
-   else if (E_icode == IIRMOVQ || E_icode == IRMMOVQ || E_icode == IMRMOVQ)
-   {
-      return E_valC;
-   }
-   else if (E_icode == ICALL || E_icode == IPUSHQ)
-   {
-      return -8;
-   }
-   else if (E_icode == IRET || E_icode == IPOPQ)
-   {
-      return 8;
-   }
-   else
-   {
-      return 0;
-   }
+   uint64_t ops[NUMALUASEL] = {0, E_valA, E_valC, (uint64_t) -8, 8};
+   return ops[props.aluA];
 }
 
-uint64_t ExecuteStage::aluB(uint64_t E_icode, uint64_t E_valB)
+uint64_t ExecuteStage::aluB(const InstrProps & props, uint64_t E_valB)
 {
-   if (E_icode == IRMMOVQ || E_icode == IMRMOVQ || E_icode == IOPQ || E_icode == ICALL || E_icode == IPUSHQ || E_icode == IRET || E_icode == IPOPQ)
-   {
-      return E_valB;
-   }
-   else if (E_icode == IRRMOVQ || E_icode == IIRMOVQ)
-   {
-      return 0;
-   }
-   else
-   {
-      return 0;
-   }
+   uint64_t ops[NUMALUBSEL] = {0, E_valB};
+   return ops[props.aluB];
 }
 
-uint64_t ExecuteStage::alufun(uint64_t E_icode, uint64_t E_ifun)
+uint64_t ExecuteStage::alufun(const InstrProps & props)
 {
-   if (E_icode == IOPQ)
-   {
-      return E_ifun;
-   }
-   else
-   {
-      return ADDQ;
-   }
+   return props.alufun;
 }
 
-bool ExecuteStage::set_cc(uint64_t E_icode)
+bool ExecuteStage::set_cc(const InstrProps & props)
 {
-   if (E_icode == IOPQ)
-   {
-      return true;
-   }
-   else
-   {
-      return false;
-   }
+   return props.setCC;
 }
 
 uint64_t ExecuteStage::e_dstE(uint64_t E_icode, uint64_t e_Cnd, uint64_t E_dstE)
@@ -144,9 +119,9 @@ uint64_t ExecuteStage::e_dstE(uint64_t E_icode, uint64_t e_Cnd, uint64_t E_dstE)
    }
 }
 
-void ExecuteStage::cc(uint64_t E_icode, uint64_t result, uint64_t opA, uint64_t opB, uint64_t alufun)
+void ExecuteStage::cc(const InstrProps & props, uint64_t result, uint64_t opA, uint64_t opB, uint64_t alufun)
 {
-   if (set_cc(E_icode))
+   if (set_cc(props))
    {
       ConditionCodes *ccInstance = ConditionCodes::getInstance();
       bool error = false;
@@ -154,50 +129,20 @@ void ExecuteStage::cc(uint64_t E_icode, uint64_t result, uint64_t opA, uint64_t
       ccInstance->setConditionCode(result == 0, ZF, error);
       ccInstance->setConditionCode(Tools::sign(result), SF, error);
 
-      if (alufun == ADDQ)
-      {
-         bool overflow = Tools::addOverflow(opA, opB);
-         ccInstance->setConditionCode(overflow, OF, error);
-      }
-      if (alufun == SUBQ)
-      {
-         bool overflow = Tools::subOverflow(opA, opB);
-         ccInstance->setConditionCode(overflow, OF, error);
-      }
+      bool of = ccInstance->getConditionCode(OF, error);
+      ccInstance->setConditionCode(InstrTable::overflow(opA, opB, alufun, of),
+                                   OF, error);
    }
 }
 
 uint64_t ExecuteStage::alu(uint64_t opA, uint64_t opB, uint64_t alufun)
 {
-   uint64_t result = 0;
-
-   if (alufun == ADDQ)
-   {
-      result = opA + opB;
-   }
-   else if (alufun == SUBQ)
-   {
-      result = opB - opA;
-   }
-   else if (alufun == XORQ)
-   {
-      result = opA ^ opB;
-   }
-   else if (alufun == ANDQ)
-   {
-      result = opA & opB;
-   }
-   else
-   {
-      result = 0;
-   }
-
-   return result;
+   return InstrTable::alu(opA, opB, alufun);
 }
 
-uint64_t ExecuteStage::cond(uint64_t icode, uint64_t ifun)
+uint64_t ExecuteStage::cond(const InstrProps & props, uint64_t ifun)
 {
-   if (icode != IJXX && icode != ICMOVXX) 
+   if (!props.useCond)
    {
       return 0;
    }
@@ -208,25 +153,7 @@ uint64_t ExecuteStage::cond(uint64_t icode, uint64_t ifun)
    bool sf = ccInstance->getConditionCode(SF, error);
    bool of = ccInstance->getConditionCode(OF, error);
 
-   switch (ifun)
-   {
-      case 0:
-         return 1;
-      case 1:
-         return (sf ^ of) | zf;
-      case 2:
-         return sf ^ of;
-      case 3:
-         return zf;
-      case 4:
-         return !zf;
-      case 5:
-         return !(sf ^ of);
-      case 6:
-         return !(sf ^ of) & !zf;
-      default:
-         return 0;
-   }
+   return InstrTable::cond(ifun, zf, sf, of);
 }
 
 
@@ -247,6 +174,7 @@ void ExecuteStage::doClockHigh(PipeReg **pregs)
    mreg->getvalA()->normal();
    mreg->getdstE()->normal();
    mreg->getdstM()->normal();
+   mreg->getpc()->normal();
 }
 
 /* setInput
@@ -8,14 +8,14 @@ class ExecuteStage: public Stage
       void setMInput(M * mreg, uint64_t stat, uint64_t icode, uint64_t Cnd, 
          uint64_t e_valE_, uint64_t valA, 
          uint64_t e_dstE_, uint64_t dstM);
-      uint64_t aluA(uint64_t E_icode, uint64_t E_valA, uint64_t E_valC);
-      uint64_t aluB(uint64_t E_icode, uint64_t E_valB);
-      uint64_t alufun(uint64_t E_icode, uint64_t E_ifun);
-      bool set_cc(uint64_t E_icode);
+      uint64_t aluA(const InstrProps & props, uint64_t E_valA, uint64_t E_valC);
+      uint64_t aluB(const InstrProps & props, uint64_t E_valB);
+      uint64_t alufun(const InstrProps & props);
+      bool set_cc(const InstrProps & props);
       uint64_t e_dstE(uint64_t E_icode, uint64_t e_Cnd, uint64_t E_dstE);
-      void cc(uint64_t E_icode, uint64_t result, uint64_t opA, uint64_t opB, uint64_t alufun);
+      void cc(const InstrProps & props, uint64_t result, uint64_t opA, uint64_t opB, uint64_t alufun);
       uint64_t alu(uint64_t opA, uint64_t opB, uint64_t alufun);
-      uint64_t cond(uint64_t icode, uint64_t ifun);
+      uint64_t cond(const InstrProps & props, uint64_t ifun);
 
    public:
       bool doClockLow(PipeReg ** pregs, Stage ** stages);
@@ -0,0 +1,172 @@
+#include <cstdint>
+#include "Memory.h"
+#include "RegisterFile.h"
+#include "ConditionCodes.h"
+#include "Instructions.h"
+#include "Status.h"
+#include "Tools.h"
+#include "InstrTable.h"
+#include "Executor.h"
+
+/*
+ * Executor constructor
+ * starts at address 0 of the program in Memory
+ */
+Executor::Executor()
+{
+   mem = Memory::getInstance();
+   rf = RegisterFile::getInstance();
+   cc = ConditionCodes::getInstance();
+   pc = 0;
+}
+
+/*
+ * step
+ * executes the instruction at pc as the pipeline stages do, updating
+ * the architectural state and pc, and describes it in r. An
+ * instruction whose status is not SAOK changes nothing.
+ *
+ * @param r - set to the registers and memory address the instruction
+ *            used and to its status
+ */
+void Executor::step(InstrRecord & r)
+{
+   r.pc = pc;
+   r.icode = r.ifun = 0;
+   r.numRegs = r.numDests = 0;
+   r.loaded = RNONE;
+   r.addr = 0;
+   r.load = r.store = r.taken = r.redirect = false;
+
+   bool error = pc >= MEMSIZE;
+   uint8_t byte = error ? 0 : mem->getByte(pc, error);
+   uint64_t icode = byte >> 4;
+   uint64_t ifun = byte & 0xf;
+   const InstrProps & props = InstrTable::lookup(icode, ifun);
+   r.icode = icode;
+   r.ifun = ifun;
+   r.stat = error ? SADR : !props.valid ? SINS :
+            pc + props.length > MEMSIZE ? SADR : icode == IHALT ? SHLT : SAOK;
+   if (r.stat != SAOK) return;
+
+   uint8_t regs = props.needRegIds ? mem->getByte(pc + 1, error) : 0xff;
+   uint64_t valC = 0;
+   for (int32_t i = 0; props.needValC && i < LONGSIZE; i++)
+      valC |= (uint64_t) mem->getByte(pc + 1 + props.needRegIds + i,
+                                      error) << (8 * i);
+   uint64_t valP = pc + props.length;
+
+   uint64_t sel[NUMREGSEL] = {RNONE, (uint64_t) regs >> 4,
+                              (uint64_t) regs & 0xf, RSP, RBP};
+   uint64_t srcA = props.selValP ? RNONE : sel[props.srcA];
+   uint64_t srcB = sel[props.srcB];
+   uint64_t dstE = sel[props.dstE];
+   uint64_t dstM = sel[props.dstM];
+   uint64_t valA = props.selValP ? valP : readReg(srcA);
+   uint64_t valB = readReg(srcB);
+
+   uint64_t aluA[NUMALUASEL] = {0, valA, valC, (uint64_t) -8, 8};
+   uint64_t aluB[NUMALUBSEL] = {0, valB};
+   uint64_t opA = aluA[props.aluA];
+   uint64_t opB = aluB[props.aluB];
+   uint64_t valE = InstrTable::alu(opA, opB, props.alufun);
+   bool cnd = !props.useCond ||
+              InstrTable::cond(ifun, cc->getConditionCode(ZF, error),
+                               cc->getConditionCode(SF, error),
+                               cc->getConditionCode(OF, error));
+
+   uint64_t addrs[NUMMADDRSEL] = {0, valE, valA};
+   uint64_t addr = addrs[props.memAddr];
+   uint64_t valM = 0;
+   error = false;
+   if (props.memRead)
+   {
+      error = addr >= MEMSIZE;
+      if (!error) valM = mem->getLong(addr, error);
+   }
+   if (props.memWrite)
+   {
+      error = addr >= MEMSIZE;
+      if (!error) mem->putLong(valA, addr, error);
+   }
+   if (error)
+   {
+      r.stat = SADR;
+      return;
+   }
+
+   if (props.setCC)
+   {
+      bool of = cc->getConditionCode(OF, error);
+      cc->setConditionCode(valE == 0, ZF, error);
+      cc->setConditionCode(Tools::sign(valE), SF, error);
+      cc->setConditionCode(InstrTable::overflow(opA, opB, props.alufun, of),
+                           OF, error);
+   }
+   if (icode != IRRMOVQ || cnd) rf->writeRegister(valE, dstE, error);
+   rf->writeRegister(valM, dstM, error);
+
+   //a cmovXX whose condition fails still writes rB, with its old value;
+   //rrmovq and jmp do not look at the condition codes
+   bool useCC = props.useCond && ifun != UNCOND;
+   uint64_t reads[EXECMAXREADS] = {srcA, srcB,
+                                   useCC ? (uint64_t) EXECCCREG : RNONE,
+                                   icode == IRRMOVQ && ifun != UNCOND ?
+                                   dstE : RNONE};
+   for (uint64_t i = 0; i < EXECMAXREADS; i++)
+      if (reads[i] != RNONE) r.reg[r.numRegs++] = reads[i];
+   uint64_t writes[EXECMAXWRITES] = {dstE, dstM,
+                                     props.setCC ? (uint64_t) EXECCCREG : RNONE};
+   for (uint64_t i = 0; i < EXECMAXWRITES; i++)
+      if (writes[i] != RNONE) r.dest[r.numDests++] = writes[i];
+   r.loaded = dstM;
+   r.load = props.memRead;
+   r.store = props.memWrite;
+   r.addr = addr;
+
+   pc = valP;
+   if (icode == IJXX)
+   {
+      pc = cnd ? valC : valP;
+      r.taken = cnd;
+      r.redirect = !cnd;
+   }
+   if (icode == ICALL)
+   {
+      pc = valC;
+      r.taken = true;
+   }
+   if (icode == IRET)
+   {
+      pc = valM;
+      r.redirect = true;
+   }
+}
+
+/*
+ * readReg
+ * @return value of register regNum, or 0 for RNONE
+ */
+uint64_t Executor::readReg(uint64_t regNum)
+{
+   bool error = false;
+   return rf->readRegister(regNum, error);
+}
+
+/*
+ * getPC
+ * @return address of the next instruction to execute
+ */
+uint64_t Executor::getPC()
+{
+   return pc;
+}
+
+/*
+ * setPC
+ * makes the instruction at pc the next one executed
+ */
+void Executor::setPC(uint64_t pc)
+{
+   this->pc = pc;
+}
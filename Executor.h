@@ -0,0 +1,53 @@
+#include <cstdint>
+#ifndef EXECUTOR_H
+#define EXECUTOR_H
+
+class Memory;
+class RegisterFile;
+class ConditionCodes;
+
+//the condition codes are numbered after the registers and RNONE when
+//an instruction's reads and writes are listed
+#define EXECCCREG (RNONE + 1)
+#define EXECMAXREADS 4
+#define EXECMAXWRITES 3
+
+//what a timing model needs to know about an executed instruction
+struct InstrRecord
+{
+   uint64_t pc;
+   uint64_t icode;
+   uint64_t ifun;
+   uint64_t stat;                   //SAOK, SHLT, SADR or SINS
+   uint64_t reg[EXECMAXREADS];      //registers read (and EXECCCREG)
+   uint64_t numRegs;
+   uint64_t dest[EXECMAXWRITES];    //registers written (and EXECCCREG)
+   uint64_t numDests;
+   uint64_t loaded;                 //register written with valM, or RNONE
+   uint64_t addr;                   //address of a load or store
+   bool load;
+   bool store;
+   bool taken;      //fetch goes to a target it knows (jmp, call, taken jXX)
+   bool redirect;   //fetch waits for the instruction (not taken jXX, ret)
+};
+
+//executes the program in Memory one instruction at a time with the
+//InstrTable properties and ALU that the pipeline stages use, following
+//the branch outcomes rather than the predictions, so the state left
+//in the RegisterFile, ConditionCodes and Memory is the state the
+//program computes. Each instruction is described for a timing model.
+class Executor
+{
+   private:
+      Memory * mem;
+      RegisterFile * rf;
+      ConditionCodes * cc;
+      uint64_t pc;
+      uint64_t readReg(uint64_t regNum);
+   public:
+      Executor();
+      void step(InstrRecord & r);
+      uint64_t getPC();
+      void setPC(uint64_t pc);
+};
+#endif
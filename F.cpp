@@ -17,6 +17,16 @@ F::F()
    predPC = new PipeRegField();
 }
 
+/*
+ * F destructor
+ *
+ * frees the fields of the F pipeline register
+ */
+F::~F()
+{
+   delete predPC;
+}
+
 /* return the predPC pipeline register field */
 PipeRegField * F::getpredPC()
 {
@@ -26,9 +36,19 @@ PipeRegField * F::getpredPC()
 /* 
  * dump
  *
- * outputs the current values of the F pipeline register
+ * outputs the current values of the F pipeline register to out
+*/
+void F::dump(std::ostream & out)
+{
+   dumpField(out, "F: predPC: ", 3, predPC->getOutput(), true);
+}
+
+/*
+ * reset
+ *
+ * returns the F pipeline register to the values set by the constructor
 */
-void F::dump()
+void F::reset()
 {
-   dumpField("F: predPC: ", 3, predPC->getOutput(), true);
+   predPC->bubble();
 }
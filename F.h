@@ -5,6 +5,8 @@ class F : public PipeReg
       PipeRegField * predPC;
    public:
       F();
+      ~F();
       PipeRegField * getpredPC();
-      void dump();
+      void dump(std::ostream & out);
+      void reset();
 };
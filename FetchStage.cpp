@@ -1,3 +1,4 @@
+#include <iostream>
 #include <string>
 #include <cstdint>
 #include "RegisterFile.h"
@@ -9,12 +10,17 @@
 #include "M.h"
 #include "W.h"
 #include "Stage.h"
+#include "InstrTable.h"
 #include "FetchStage.h"
 #include "Status.h"
 #include "Debug.h"
 #include "Instructions.h"
 #include "Memory.h"
 #include "Tools.h"
+#include "Forwarding.h"
+#include "AccessProfile.h"
+#include "ReplayLog.h"
+#include "Energy.h"
 
 /*
  * doClockLow:
@@ -41,6 +47,8 @@ bool FetchStage::doClockLow(PipeReg **pregs, Stage **stages)
    bool error = false;
 
    uint64_t readByte = mem->getByte(f_pc, error);
+   if (AccessProfile::isEnabled()) AccessProfile::getInstance()->fetch(f_pc);
+   if (Energy::isEnabled()) Energy::getInstance()->add(ENFETCH, f_pc);
 
    if (error)
    {
@@ -50,9 +58,10 @@ bool FetchStage::doClockLow(PipeReg **pregs, Stage **stages)
    {
       icode = Tools::getBits(readByte, 4, 7);
       ifun = Tools::getBits(readByte, 0, 3);
+      const InstrProps & props = InstrTable::lookup(icode, ifun);
 
-      bool need_regId = needRegIds(icode);
-      bool need_valC = needValC(icode);
+      bool need_regId = needRegIds(props);
+      bool need_valC = needValC(props);
 
       getRegIds(f_pc, icode, rA, rB, need_regId);
 
@@ -60,11 +69,16 @@ bool FetchStage::doClockLow(PipeReg **pregs, Stage **stages)
 
       valP = PCincrement(f_pc, need_regId, need_valC);
 
-      freg->getpredPC()->setInput(predictPC(icode, valC, valP));
+      freg->getpredPC()->setInput(predictPC(props, valC, valP));
    }
 
+   TRACE(TRACEFETCH, std::cout << "fetch: pc " << std::hex << f_pc
+         << " icode " << icode << " ifun " << ifun << " stat " << stat
+         << std::endl);
+
    // Set inputs for the D register
    setDInput(dreg, stat, icode, ifun, rA, rB, valC, valP);
+   dreg->getpc()->setInput(f_pc);
 
    return false;
 }
@@ -80,6 +94,21 @@ void FetchStage::doClockHigh(PipeReg **pregs)
    F *freg = (F *)pregs[FREG];
    D *dreg = (D *)pregs[DREG];
 
+   if (Forwarding::getInstance()->isStalling())
+   {
+      //decode is waiting for an operand: hold F and D
+      freg->getpredPC()->stall();
+      dreg->getstat()->stall();
+      dreg->geticode()->stall();
+      dreg->getifun()->stall();
+      dreg->getrA()->stall();
+      dreg->getrB()->stall();
+      dreg->getvalC()->stall();
+      dreg->getvalP()->stall();
+      dreg->getpc()->stall();
+      return;
+   }
+
    freg->getpredPC()->normal();
    dreg->getstat()->normal();
    dreg->geticode()->normal();
@@ -88,6 +117,7 @@ void FetchStage::doClockHigh(PipeReg **pregs)
    dreg->getrB()->normal();
    dreg->getvalC()->normal();
    dreg->getvalP()->normal();
+   dreg->getpc()->normal();
 }
 
 uint64_t FetchStage::selectPC(F *freg, M *mreg, W *wreg)
@@ -113,11 +143,9 @@ uint64_t FetchStage::selectPC(F *freg, M *mreg, W *wreg)
    }
 }
 
-bool FetchStage::needRegIds(uint64_t f_icode)
+bool FetchStage::needRegIds(const InstrProps & props)
 {
-   return (f_icode == IRRMOVQ || f_icode == IOPQ || f_icode == IPUSHQ ||
-           f_icode == IPOPQ || f_icode == IIRMOVQ || f_icode == IRMMOVQ ||
-           f_icode == IMRMOVQ);
+   return props.needRegIds;
 }
 
 void FetchStage::getRegIds(uint64_t f_pc, uint64_t icode, uint64_t &rA, uint64_t &rB, bool need_regId)
@@ -139,10 +167,9 @@ void FetchStage::getRegIds(uint64_t f_pc, uint64_t icode, uint64_t &rA, uint64_t
    }
 }
 
-bool FetchStage::needValC(uint64_t f_icode)
+bool FetchStage::needValC(const InstrProps & props)
 {
-   return (f_icode == IIRMOVQ || f_icode == IRMMOVQ || f_icode == IMRMOVQ ||
-           f_icode == IJXX || f_icode == ICALL);
+   return props.needValC;
 }
 
 void FetchStage::buildValC(uint64_t f_pc, uint64_t icode, int64_t &valC, bool need_regId, bool need_valC)
@@ -171,30 +198,15 @@ void FetchStage::buildValC(uint64_t f_pc, uint64_t icode, int64_t &valC, bool ne
    }
 }
 
-uint64_t FetchStage::predictPC(uint64_t f_icode, uint64_t f_valC, uint64_t f_valP)
+uint64_t FetchStage::predictPC(const InstrProps & props, uint64_t f_valC, uint64_t f_valP)
 {
-   if (f_icode == IJXX || f_icode == ICALL)
-   {
-      return f_valC;
-   }
-   return f_valP;
+   uint64_t predPC[2] = {f_valP, f_valC};
+   return predPC[props.predValC];
 }
 
 uint64_t FetchStage::PCincrement(uint64_t f_pc, bool needRegIds, bool needValC)
 {
-   if (needRegIds)
-   {
-      if (needValC)
-      {
-         return f_pc + 10;
-      }
-      return f_pc + 2;
-   }
-   if (needValC)
-   {
-      return f_pc + 9;
-   }
-   return f_pc + 1;
+   return f_pc + 1 + needRegIds + 8 * needValC;
 }
 
 /* setDInput
@@ -6,14 +6,14 @@ class FetchStage: public Stage
       void setDInput(D * dreg, uint64_t stat, uint64_t icode, uint64_t ifun, 
                      uint64_t rA, uint64_t rB,
                      uint64_t valC, uint64_t valP);
-      u_int64_t selectPC(F * freg, M * mreg, W * wreg);
-      bool needRegIds(uint64_t f_icode);
-      bool needValC(uint64_t f_icode);
-      uint64_t predictPC(uint64_t f_icode, uint64_t f_valC, uint64_t f_valP);
+      bool needRegIds(const InstrProps & props);
+      bool needValC(const InstrProps & props);
+      uint64_t predictPC(const InstrProps & props, uint64_t f_valC, uint64_t f_valP);
       uint64_t PCincrement(uint64_t f_pc, bool needRegIds, bool needValC);
       void getRegIds(uint64_t f_pc, uint64_t icode, uint64_t & rA, uint64_t & rB, bool need_regId);
       void buildValC(uint64_t f_pc, uint64_t icode, int64_t & valC, bool need_regId, bool need_valC);
    public:
+      u_int64_t selectPC(F * freg, M * mreg, W * wreg);
       bool doClockLow(PipeReg ** pregs, Stage ** stages);
       void doClockHigh(PipeReg ** pregs);
 
@@ -0,0 +1,242 @@
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <cstdint>
+#include <string.h>
+#include "Memory.h"
+#include "RegisterFile.h"
+#include "ConditionCodes.h"
+#include "Tools.h"
+#include "PipeRegField.h"
+#include "PipeReg.h"
+#include "Machine.h"
+#include "ReplayLog.h"
+#include "Fingerprint.h"
+
+/*
+ * Fingerprint file layout:
+ *   "YESSFP01"
+ *   one record of PRINTSIZE bytes per cycle: the NUMPRINTS 32-bit
+ *   hashes of the components, each 4 bytes little endian
+ * The records are fixed size, so two files are compared a block of
+ * records at a time and only a block that differs is examined.
+ */
+
+//records compared at a time by compare
+#define PRINTBLOCK 4096
+
+Fingerprint * Fingerprint::printInstance = NULL;
+
+/*
+ * Fingerprint constructor
+ */
+Fingerprint::Fingerprint()
+{
+   for (int32_t i = 0; i < NUMFIELDS; i++) fields[i] = NULL;
+   for (int32_t i = 0; i < MEMWORDS; i++) words[i] = 0;
+   memoryHash = 0;
+}
+
+/*
+ * getInstance
+ * if printInstance is NULL then creates a Fingerprint object
+ * and sets printInstance to point to it; returns printInstance
+ *
+ * @return printInstance
+ */
+Fingerprint * Fingerprint::getInstance()
+{
+   if (printInstance == NULL)
+   {
+      printInstance = new Fingerprint();
+   }
+   return printInstance;
+}
+
+/*
+ * name
+ * @return name of the component (F, D, E, M, W, registers, ...)
+ */
+const char * Fingerprint::name(int32_t component)
+{
+   static const char * names[NUMPRINTS] = {
+      "F", "D", "E", "M", "W", "registers", "condition codes", "memory"
+   };
+   return names[component];
+}
+
+/*
+ * mix
+ * @return value with every bit spread over the whole word (the
+ *         splitmix64 finalizer)
+ */
+uint64_t Fingerprint::mix(uint64_t value)
+{
+   value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+   value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+   return value ^ (value >> 31);
+}
+
+/*
+ * wordHash
+ * @return hash of memory word number word holding value; the memory
+ *         hash is the XOR of the hashes of all of the words
+ */
+uint64_t Fingerprint::wordHash(uint64_t word, uint64_t value)
+{
+   return mix(value ^ mix(word + 1));
+}
+
+/*
+ * hashMemory
+ * hashes every word of the memory of machine
+ */
+void Fingerprint::hashMemory(Machine & machine)
+{
+   bool error = false;
+   memoryHash = 0;
+   for (int32_t i = 0; i < MEMWORDS; i++)
+   {
+      words[i] = machine.getLong(i * LONGSIZE, error);
+      memoryHash ^= wordHash(i, words[i]);
+   }
+   dirty.clear();
+}
+
+/*
+ * compute
+ * fills prints with the hash of each component of the state of
+ * machine, rehashing only the memory words stored to since the last
+ * call
+ */
+void Fingerprint::compute(Machine & machine, uint32_t prints[NUMPRINTS])
+{
+   uint64_t hashes[NUMPRINTS];
+   bool error = false;
+
+   int32_t field = 0;
+   for (int32_t reg = 0; reg < NUMPIPEREGS; reg++)
+   {
+      hashes[reg] = reg;
+      for (int32_t i = 0; i < ReplayLog::numFields[reg]; i++, field++)
+         hashes[reg] = mix(hashes[reg] ^ fields[field]->getOutput());
+   }
+   hashes[PRINTREGS] = PRINTREGS;
+   for (int32_t i = 0; i < REGSIZE; i++)
+      hashes[PRINTREGS] = mix(hashes[PRINTREGS] ^ machine.readRegister(i, error));
+   hashes[PRINTCC] = mix(machine.getConditionCode(ZF, error) |
+                         machine.getConditionCode(SF, error) << 1 |
+                         machine.getConditionCode(OF, error) << 2);
+
+   const std::vector<uint64_t> & stored = dirty.getWords();
+   for (uint64_t i = 0; i < stored.size(); i++)
+   {
+      uint64_t word = stored[i];
+      uint64_t value = machine.getLong(word * LONGSIZE, error);
+      memoryHash ^= wordHash(word, words[word]) ^ wordHash(word, value);
+      words[word] = value;
+   }
+   dirty.clear();
+   hashes[PRINTMEMORY] = memoryHash;
+
+   for (int32_t i = 0; i < NUMPRINTS; i++)
+      prints[i] = (uint32_t) (hashes[i] ^ (hashes[i] >> 32));
+}
+
+/*
+ * record
+ * runs machine until a halt reaches the writeback stage, writing the
+ * fingerprint of the state at the end of each cycle to fileName
+ *
+ * @return false if the file cannot be written
+ */
+bool Fingerprint::record(Machine & machine, const char * fileName)
+{
+   std::ofstream out(fileName, std::ios::binary);
+   if (!out.is_open()) return false;
+
+   PipeReg * pregs[NUMPIPEREGS];
+   uint32_t prints[NUMPRINTS];
+   char record[PRINTSIZE];
+
+   for (int32_t i = 0; i < NUMPIPEREGS; i++) pregs[i] = machine.getPipeReg(i);
+   ReplayLog::bindFields(pregs, fields);
+   hashMemory(machine);
+   out.write("YESSFP01", LONGSIZE);
+   Memory::getInstance()->addObserver(&dirty);
+   while (!machine.isHalted())
+   {
+      machine.step(1);
+      compute(machine, prints);
+      for (int32_t i = 0; i < PRINTSIZE; i++)
+         record[i] = (char) Tools::getByte(prints[i / 4], i % 4);
+      out.write(record, PRINTSIZE);
+   }
+   Memory::getInstance()->removeObserver(&dirty);
+   return out.good();
+}
+
+/*
+ * compare
+ * compares the fingerprint files first and second and outputs either
+ * the number of cycles in which they match or the first cycle in
+ * which they differ and the components that differ in it; a file
+ * that ends first differs in the cycle after its last one
+ *
+ * @return 0 if the files match, 1 if they differ and -1 if either
+ *         cannot be read or is not a fingerprint file
+ */
+int32_t Fingerprint::compare(const char * first, const char * second)
+{
+   std::ifstream in[2];
+   const char * names[2] = {first, second};
+   char magic[LONGSIZE];
+   for (int32_t f = 0; f < 2; f++)
+   {
+      in[f].open(names[f], std::ios::binary);
+      if (!in[f].read(magic, LONGSIZE) || memcmp(magic, "YESSFP01", LONGSIZE))
+      {
+         std::cout << names[f] << " is not a fingerprint file" << std::endl;
+         return -1;
+      }
+   }
+
+   std::vector<char> blocks[2];
+   uint64_t counts[2];
+   uint64_t cycle = 0;
+   blocks[0].resize(PRINTBLOCK * PRINTSIZE);
+   blocks[1].resize(PRINTBLOCK * PRINTSIZE);
+   while (true)
+   {
+      for (int32_t f = 0; f < 2; f++)
+      {
+         in[f].read(&blocks[f][0], PRINTBLOCK * PRINTSIZE);
+         counts[f] = in[f].gcount() / PRINTSIZE;
+      }
+      uint64_t both = counts[0] < counts[1] ? counts[0] : counts[1];
+      if (memcmp(&blocks[0][0], &blocks[1][0], both * PRINTSIZE) != 0)
+      {
+         uint64_t i = 0;
+         while (memcmp(&blocks[0][i * PRINTSIZE], &blocks[1][i * PRINTSIZE],
+                       PRINTSIZE) == 0) i++;
+         std::cout << "First difference in cycle " << cycle + i << ":";
+         for (int32_t c = 0; c < NUMPRINTS; c++)
+            if (memcmp(&blocks[0][i * PRINTSIZE + c * 4],
+                       &blocks[1][i * PRINTSIZE + c * 4], 4) != 0)
+               std::cout << " " << name(c);
+         std::cout << std::endl;
+         return 1;
+      }
+      cycle += both;
+      if (counts[0] != counts[1])
+      {
+         const char * shorter = counts[0] < counts[1] ? first : second;
+         std::cout << "First difference in cycle " << cycle << ": " << shorter
+                   << " ends after " << cycle << " cycles" << std::endl;
+         return 1;
+      }
+      if (both < PRINTBLOCK) break;
+   }
+   std::cout << "The fingerprints match in all " << cycle << " cycles" << std::endl;
+   return 0;
+}
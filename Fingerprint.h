@@ -0,0 +1,44 @@
+#include <cstdint>
+#include <vector>
+#include "DirtyWords.h"
+#ifndef FINGERPRINT_H
+#define FINGERPRINT_H
+
+//components of the state that are hashed separately each cycle; the
+//first five are the pipeline registers, indexed by FREG, ..., WREG
+#define PRINTREGS 5                    //register file
+#define PRINTCC (PRINTREGS + 1)        //condition codes
+#define PRINTMEMORY (PRINTCC + 1)      //memory
+#define NUMPRINTS (PRINTMEMORY + 1)
+//bytes per cycle in a fingerprint file (32 bits per component)
+#define PRINTSIZE (NUMPRINTS * 4)
+
+class Machine;
+class PipeRegField;
+
+//fingerprint of the state of the PIPE machine at the end of every
+//cycle: a 32-bit hash of each pipeline register, the register file,
+//the condition codes and the memory. The memory hash is the XOR of a
+//hash of each word and its address, so a cycle only rehashes the
+//words stored to in it. Two fingerprint files are
+//compared to find the first cycle in which two runs differ.
+class Fingerprint
+{
+   private:
+      static Fingerprint * printInstance;
+      Fingerprint();
+      PipeRegField * fields[NUMFIELDS];
+      uint64_t words[MEMWORDS];           //memory when last hashed
+      DirtyWords dirty;                   //words stored to in this cycle
+      uint64_t memoryHash;
+      static uint64_t mix(uint64_t value);
+      static uint64_t wordHash(uint64_t word, uint64_t value);
+      void hashMemory(Machine & machine);
+      void compute(Machine & machine, uint32_t prints[NUMPRINTS]);
+   public:
+      static Fingerprint * getInstance();
+      static const char * name(int32_t component);
+      bool record(Machine & machine, const char * fileName);
+      static int32_t compare(const char * first, const char * second);
+};
+#endif
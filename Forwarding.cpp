@@ -0,0 +1,169 @@
+#include <iostream>
+#include <string>
+#include <cstdint>
+#include "Forwarding.h"
+
+//fwdInstance will be initialized to the single Forwarding object; a
+//multicore run points it at the forwarding network of each core
+thread_local Forwarding * Forwarding::fwdInstance = NULL;
+
+/*
+ * Forwarding constructor
+ * starts with every path enabled and the counts cleared
+ */
+Forwarding::Forwarding()
+{
+   enabled = (1 << NUMFWDPATHS) - 1;
+   stalling = false;
+   for (int32_t i = 0; i <= FWDREGFILE; i++) reads[i] = 0;
+   for (int32_t i = 0; i < NUMFWDPATHS; i++) stalls[i] = 0;
+   stallCycles = 0;
+}
+
+/*
+ * getInstance
+ * if fwdInstance is NULL then creates a Forwarding object
+ * and sets fwdInstance to point to it; returns fwdInstance
+ *
+ * @return fwdInstance
+ */
+Forwarding * Forwarding::getInstance()
+{
+   if (fwdInstance == NULL)
+   {
+      fwdInstance = new Forwarding();
+   }
+   return fwdInstance;
+}
+
+/*
+ * create
+ * creates the forwarding network of another simulated core, with the
+ * paths that are enabled in the calling thread's instance
+ *
+ * @return pointer to the new Forwarding object
+ */
+Forwarding * Forwarding::create()
+{
+   Forwarding * fwd = new Forwarding();
+   fwd->enabled = getInstance()->enabled;
+   return fwd;
+}
+
+/*
+ * setInstance
+ * makes instance the Forwarding object that getInstance returns to
+ * the calling thread
+ */
+void Forwarding::setInstance(Forwarding * instance)
+{
+   fwdInstance = instance;
+}
+
+/*
+ * name
+ * @return name of the path (FWDEVALE, ...) or of the register file
+ */
+const char * Forwarding::name(uint64_t path)
+{
+   static const char * names[FWDREGFILE + 1] = {"e_valE", "m_valM", "M_valE",
+                                                "W_valM", "W_valE", "regfile"};
+   return path <= FWDREGFILE ? names[path] : "";
+}
+
+/*
+ * parsePaths
+ * converts a comma separated list of path names ("e_valE,W_valM")
+ * or "all" to a mask
+ *
+ * @return false if a name is not a path
+ */
+bool Forwarding::parsePaths(const char * names, uint32_t & mask)
+{
+   std::string list(names);
+   uint64_t start = 0;
+   mask = 0;
+   while (start <= list.length())
+   {
+      uint64_t end = list.find(',', start);
+      if (end == std::string::npos) end = list.length();
+      std::string word = list.substr(start, end - start);
+      int32_t path = 0;
+      while (path < NUMFWDPATHS && word != name(path)) path++;
+      if (word == "all") mask |= (1 << NUMFWDPATHS) - 1;
+      else if (path < NUMFWDPATHS) mask |= 1 << path;
+      else return false;
+      start = end + 1;
+   }
+   return true;
+}
+
+/*
+ * setEnabled
+ * @param mask - bit FWDEVALE, ... is 1 if that path is enabled
+ */
+void Forwarding::setEnabled(uint32_t mask)
+{
+   enabled = mask;
+}
+
+/*
+ * isEnabled
+ * @return true if values can be forwarded through path
+ */
+bool Forwarding::isEnabled(uint64_t path)
+{
+   return (enabled >> path) & 1;
+}
+
+/*
+ * operands
+ * called by the decode stage every cycle with the sources of its two
+ * operands; counts the reads if both are available and otherwise the
+ * stall on each disabled path
+ *
+ * @param pathA, pathB - FWDEVALE, ..., FWDREGFILE or FWDNONE
+ * @return true if decode must stall this cycle
+ */
+bool Forwarding::operands(uint64_t pathA, uint64_t pathB)
+{
+   bool stallA = pathA < NUMFWDPATHS && !isEnabled(pathA);
+   bool stallB = pathB < NUMFWDPATHS && !isEnabled(pathB);
+   stalling = stallA || stallB;
+   if (stalling)
+   {
+      if (stallA) stalls[pathA]++;
+      if (stallB) stalls[pathB]++;
+      stallCycles++;
+      return true;
+   }
+   if (pathA <= FWDREGFILE) reads[pathA]++;
+   if (pathB <= FWDREGFILE) reads[pathB]++;
+   return false;
+}
+
+/*
+ * isStalling
+ * @return true if the decode stage stalled in the current cycle
+ */
+bool Forwarding::isStalling()
+{
+   return stalling;
+}
+
+/*
+ * dump
+ * outputs the operands supplied by each source, the stalls caused by
+ * each disabled path and the total number of stall cycles
+ */
+void Forwarding::dump()
+{
+   std::cout << std::dec << "\nForwarding:";
+   for (uint64_t path = 0; path <= FWDREGFILE; path++)
+   {
+      std::cout << " " << name(path) << " " << reads[path];
+      if (path < NUMFWDPATHS && !isEnabled(path))
+         std::cout << " (disabled, " << stalls[path] << " stalls)";
+   }
+   std::cout << "\nstall cycles: " << stallCycles << std::endl;
+}
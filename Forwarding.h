@@ -0,0 +1,41 @@
+#include <cstdint>
+#ifndef FORWARDING_H
+#define FORWARDING_H
+
+//forwarding paths into the decode stage, in priority order
+#define FWDEVALE 0      //e_valE: result of the execute stage
+#define FWDMVALM 1      //m_valM: word read by the memory stage
+#define FWDMVALE 2      //M_valE
+#define FWDWVALM 3      //W_valM
+#define FWDWVALE 4      //W_valE
+#define NUMFWDPATHS 5
+#define FWDREGFILE NUMFWDPATHS   //operand read from the register file
+#define FWDNONE (NUMFWDPATHS + 1) //no register operand (RNONE or valP)
+
+//configuration and usage counts of the forwarding network. An operand
+//whose youngest producer can only reach decode through a disabled
+//path stalls the F and D registers and inserts a bubble into E until
+//the value arrives through a later enabled path or the register file.
+class Forwarding
+{
+   private:
+      static thread_local Forwarding * fwdInstance;
+      Forwarding();
+      uint32_t enabled;                       //mask of enabled paths
+      bool stalling;                          //true if decode stalls this cycle
+      uint64_t reads[FWDREGFILE + 1];         //operands supplied by each source
+      uint64_t stalls[NUMFWDPATHS];           //operand stalls on each path
+      uint64_t stallCycles;
+   public:
+      static Forwarding * getInstance();
+      static Forwarding * create();
+      static void setInstance(Forwarding * instance);
+      static const char * name(uint64_t path);
+      static bool parsePaths(const char * names, uint32_t & mask);
+      void setEnabled(uint32_t mask);
+      bool isEnabled(uint64_t path);
+      bool operands(uint64_t pathA, uint64_t pathB);
+      bool isStalling();
+      void dump();
+};
+#endif
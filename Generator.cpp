@@ -0,0 +1,344 @@
+#include <string>
+#include <vector>
+#include <random>
+#include <cstdint>
+#include <stdio.h>
+#include "Memory.h"
+#include "RegisterFile.h"
+#include "Tools.h"
+#include "Instructions.h"
+#include "InstrTable.h"
+#include "Generator.h"
+
+/*
+ * Generator constructor
+ *
+ * @param config - size and mix of the program; see valid
+ */
+Generator::Generator(const GenConfig & config)
+{
+   this->config = config;
+   pc = 0;
+}
+
+/*
+ * valid
+ * @return true if the size is GENMINSIZE to GENMAXSIZE bytes and
+ *         loops run at least once
+ */
+bool Generator::valid(const GenConfig & config)
+{
+   return config.size >= GENMINSIZE && config.size <= GENMAXSIZE &&
+          config.iterations > 0;
+}
+
+/*
+ * pick
+ * @return random number from 0 to limit - 1
+ */
+uint64_t Generator::pick(uint64_t limit)
+{
+   return random() % limit;
+}
+
+/*
+ * workRegister
+ * @return random register that the program is free to overwrite
+ */
+uint64_t Generator::workRegister()
+{
+   static const uint64_t work[] = {RAX, RCX, RDX, RBX, RSI, RDI,
+                                   R8, R9, R10, R11};
+   return work[pick(sizeof(work) / sizeof(work[0]))];
+}
+
+/*
+ * emit
+ * appends an instruction at pc
+ *
+ * @return index of the instruction in code, for patching its valC
+ */
+uint64_t Generator::emit(uint64_t icode, uint64_t ifun, uint64_t rA,
+                         uint64_t rB, uint64_t valC)
+{
+   GenInstr instr = {pc, icode, ifun, rA, rB, valC};
+   code.push_back(instr);
+   pc += InstrTable::lookup(icode, ifun).length;
+   return code.size() - 1;
+}
+
+/*
+ * nop
+ * appends a nop
+ */
+void Generator::nop()
+{
+   emit(INOP, FNONE, RNONE, RNONE, 0);
+}
+
+/*
+ * aluBlock
+ * appends a chain of 2 to 6 OPq, irmovq, rrmovq and cmovXX
+ * instructions on the work registers
+ */
+void Generator::aluBlock()
+{
+   uint64_t count = 2 + pick(5);
+   for (uint64_t i = 0; i < count; i++)
+   {
+      uint64_t kind = pick(4);
+      if (kind < 2)
+         emit(IOPQ, pick(XORQ + 1), workRegister(), workRegister(), 0);
+      else if (kind == 2)
+         emit(IIRMOVQ, FNONE, RNONE, workRegister(), pick(0x2000) - 0x1000);
+      else
+         emit(ICMOVXX, pick(GREATER + 1), workRegister(), workRegister(), 0);
+   }
+}
+
+/*
+ * memoryBlock
+ * appends 1 to 3 loads from and stores to the data words, or pushes
+ * followed by pops; a nop follows each load so that its value can be
+ * forwarded to the next instruction
+ */
+void Generator::memoryBlock()
+{
+   uint64_t count = 1 + pick(3);
+   for (uint64_t i = 0; i < count; i++)
+   {
+      uint64_t kind = pick(3);
+      uint64_t offset = LONGSIZE * pick(GENDATAWORDS);
+      if (kind == 0)
+      {
+         emit(IMRMOVQ, FNONE, workRegister(), RBP, offset);
+         nop();
+      }
+      else if (kind == 1)
+         emit(IRMMOVQ, FNONE, workRegister(), RBP, offset);
+      else
+      {
+         emit(IPUSHQ, FNONE, workRegister(), RNONE, 0);
+         emit(IPOPQ, FNONE, workRegister(), RNONE, 0);
+         nop();
+      }
+   }
+}
+
+/*
+ * callBlock
+ * appends a call of a random leaf function
+ */
+void Generator::callBlock()
+{
+   if (functions.empty()) aluBlock();
+   else emit(ICALL, FNONE, RNONE, RNONE, functions[pick(functions.size())]);
+}
+
+/*
+ * loopBlock
+ * appends a loop that runs 1 to config.iterations times. Each
+ * iteration runs 1 to 3 blocks, then skips an ALU chain if a
+ * condition holds for the data word at offset %r12 and moves %r12 to
+ * the next word. The two instructions at the target of each
+ * conditional jump are nops, since the pipeline fetches them before
+ * the jump is resolved and does not squash them if it is not taken.
+ */
+void Generator::loopBlock()
+{
+   emit(IIRMOVQ, FNONE, RNONE, R14, 1 + pick(config.iterations));
+   uint64_t top = pc;
+   nop();
+   nop();
+   uint64_t count = 1 + pick(3);
+   for (uint64_t i = 0; i < count; i++) block(false, true);
+
+   uint64_t reg = workRegister();
+   dataRefs.push_back(emit(IMRMOVQ, FNONE, reg, R12, 0));
+   nop();
+   emit(IOPQ, ANDQ, reg, reg, 0);
+   uint64_t jump = emit(IJXX, LESSEQ + pick(GREATER), RNONE, RNONE, 0);
+   aluBlock();
+   code[jump].valC = pc;
+   nop();
+   nop();
+
+   emit(IIRMOVQ, FNONE, RNONE, R13, LONGSIZE);
+   emit(IOPQ, ADDQ, R13, R12, 0);
+   emit(IIRMOVQ, FNONE, RNONE, R13, LONGSIZE * (GENDATAWORDS - 1));
+   emit(IOPQ, ANDQ, R13, R12, 0);
+   emit(IIRMOVQ, FNONE, RNONE, R13, 1);
+   emit(IOPQ, SUBQ, R13, R14, 0);
+   emit(IJXX, NOTEQUAL, RNONE, RNONE, top);
+}
+
+/*
+ * block
+ * appends a block of a kind chosen using the weights of the mix
+ *
+ * @param loops - true if a loop may be chosen
+ * @param calls - true if a call may be chosen
+ */
+void Generator::block(bool loops, bool calls)
+{
+   uint64_t call = calls ? config.call : 0;
+   uint64_t loop = loops ? config.loop : 0;
+   uint64_t total = config.alu + config.memory + call + loop;
+   if (total == 0)
+   {
+      aluBlock();
+      return;
+   }
+   uint64_t choice = pick(total);
+   if (choice < config.alu) aluBlock();
+   else if (choice < config.alu + config.memory) memoryBlock();
+   else if (choice < config.alu + config.memory + call) callBlock();
+   else loopBlock();
+}
+
+/*
+ * generate
+ * generates the program: set up of the registers, a jump over
+ * GENFUNCTIONS leaf functions if calls are in the mix, blocks until
+ * config.size bytes of code have been generated, halt, and then the
+ * GENDATAWORDS data words after at least 8 bytes of 0s
+ *
+ * @return the program in .yo format
+ */
+std::string Generator::generate()
+{
+   random.seed(config.seed);
+   code.clear();
+   dataRefs.clear();
+   functions.clear();
+   pc = 0;
+
+   emit(IIRMOVQ, FNONE, RNONE, RSP, MEMSIZE);
+   dataRefs.push_back(emit(IIRMOVQ, FNONE, RNONE, RBP, 0));
+   emit(IIRMOVQ, FNONE, RNONE, R12, 0);
+   if (config.call > 0)
+   {
+      uint64_t jump = emit(IJXX, UNCOND, RNONE, RNONE, 0);
+      for (uint64_t i = 0; i < GENFUNCTIONS; i++)
+      {
+         functions.push_back(pc);
+         uint64_t count = 1 + pick(2);
+         for (uint64_t j = 0; j < count; j++) block(false, false);
+         //the pipeline fetches the three instructions after a ret
+         //before the return address reaches it
+         emit(IRET, FNONE, RNONE, RNONE, 0);
+         nop();
+         nop();
+         nop();
+      }
+      code[jump].valC = pc;
+   }
+   while (pc < config.size) block(true, true);
+   emit(IHALT, FNONE, RNONE, RNONE, 0);
+
+   uint64_t data = (pc + 2 * LONGSIZE - 1) / LONGSIZE * LONGSIZE;
+   for (uint64_t i = 0; i < dataRefs.size(); i++) code[dataRefs[i]].valC += data;
+
+   std::string program;
+   for (uint64_t i = 0; i < code.size(); i++)
+   {
+      const GenInstr & instr = code[i];
+      const InstrProps & props = InstrTable::lookup(instr.icode, instr.ifun);
+      char bytes[2 * 10 + 1];
+      int length = sprintf(bytes, "%01x%01x", (unsigned) instr.icode,
+                           (unsigned) instr.ifun);
+      if (props.needRegIds)
+         length += sprintf(bytes + length, "%01x%01x", (unsigned) instr.rA,
+                           (unsigned) instr.rB);
+      for (int32_t j = 0; props.needValC && j < LONGSIZE; j++)
+         length += sprintf(bytes + length, "%02x",
+                           (unsigned) (instr.valC >> (8 * j)) & 0xff);
+      program += line(instr.address, bytes, text(instr));
+   }
+   for (uint64_t i = 0; i < GENDATAWORDS; i++)
+   {
+      uint64_t value = pick(2001) - 1000;
+      char bytes[2 * LONGSIZE + 1];
+      char comment[32];
+      for (int32_t j = 0; j < LONGSIZE; j++)
+         sprintf(bytes + 2 * j, "%02x", (unsigned) (value >> (8 * j)) & 0xff);
+      sprintf(comment, ".quad %lld", (long long) value);
+      program += line(data + LONGSIZE * i, bytes, comment);
+   }
+   return program;
+}
+
+/*
+ * text
+ * @return assembly language for instr, with addresses in hex
+ */
+std::string Generator::text(const GenInstr & instr)
+{
+   static const char * regs[] = {"%rax", "%rcx", "%rdx", "%rbx", "%rsp",
+                                 "%rbp", "%rsi", "%rdi", "%r8", "%r9",
+                                 "%r10", "%r11", "%r12", "%r13", "%r14"};
+   static const char * ops[] = {"addq", "subq", "andq", "xorq"};
+   static const char * moves[] = {"rrmovq", "cmovle", "cmovl", "cmove",
+                                  "cmovne", "cmovge", "cmovg"};
+   static const char * jumps[] = {"jmp", "jle", "jl", "je", "jne", "jge", "jg"};
+   char buffer[64];
+   switch (instr.icode)
+   {
+      case IHALT: return "halt";
+      case INOP: return "nop";
+      case IRET: return "ret";
+      case ICMOVXX:
+         sprintf(buffer, "%s %s, %s", moves[instr.ifun], regs[instr.rA],
+                 regs[instr.rB]);
+         break;
+      case IIRMOVQ:
+         sprintf(buffer, "irmovq $%lld, %s", (long long) instr.valC,
+                 regs[instr.rB]);
+         break;
+      case IRMMOVQ:
+         sprintf(buffer, "rmmovq %s, %lld(%s)", regs[instr.rA],
+                 (long long) instr.valC, regs[instr.rB]);
+         break;
+      case IMRMOVQ:
+         sprintf(buffer, "mrmovq %lld(%s), %s", (long long) instr.valC,
+                 regs[instr.rB], regs[instr.rA]);
+         break;
+      case IOPQ:
+         sprintf(buffer, "%s %s, %s", ops[instr.ifun], regs[instr.rA],
+                 regs[instr.rB]);
+         break;
+      case IJXX:
+         sprintf(buffer, "%s 0x%llx", jumps[instr.ifun],
+                 (unsigned long long) instr.valC);
+         break;
+      case ICALL:
+         sprintf(buffer, "call 0x%llx", (unsigned long long) instr.valC);
+         break;
+      case IPUSHQ:
+         sprintf(buffer, "pushq %s", regs[instr.rA]);
+         break;
+      case IPOPQ:
+         sprintf(buffer, "popq %s", regs[instr.rA]);
+         break;
+      default:
+         buffer[0] = '\0';
+   }
+   return buffer;
+}
+
+/*
+ * line
+ * formats a line of a .yo file: the address in columns 0 to 4, the
+ * bytes from column 7, and the comment after the | in column 28
+ *
+ * @return the line, ending with a newline
+ */
+std::string Generator::line(uint64_t address, const std::string & bytes,
+                            const std::string & comment)
+{
+   char prefix[8];
+   sprintf(prefix, "0x%03llx:", (unsigned long long) address);
+   std::string result = std::string(prefix) + " " + bytes;
+   result.resize(28, ' ');
+   return result + "| " + comment + "\n";
+}
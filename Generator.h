@@ -0,0 +1,81 @@
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <random>
+#ifndef GENERATOR_H
+#define GENERATOR_H
+
+//defaults of a generated program
+#define GENSIZE 0x800         //bytes of code
+#define GENALU 4              //weights of the kinds of block in the mix
+#define GENMEMORY 2
+#define GENCALL 1
+#define GENLOOP 1
+#define GENITERATIONS 16      //most iterations of a loop
+
+//layout of a generated program
+#define GENFUNCTIONS 4        //leaf functions that call blocks use
+#define GENDATAWORDS 32       //64-bit words of data, a power of 2
+#define GENSTACK 0x100        //bytes kept free below the stack top
+#define GENSLACK 0x200        //room for the block that crosses size
+#define GENMINSIZE 0x40
+#define GENMAXSIZE (MEMSIZE - GENSTACK - 8 * GENDATAWORDS - GENSLACK)
+
+//size and instruction mix of a generated program
+struct GenConfig
+{
+   uint64_t seed;
+   uint64_t size;         //approximate bytes of code
+   uint64_t alu;          //weights of ALU chains, loads and stores,
+   uint64_t memory;       //calls and loops with data-dependent
+   uint64_t call;         //branches
+   uint64_t loop;
+   uint64_t iterations;   //each loop runs 1 to iterations times
+};
+
+//an instruction of the program being generated
+struct GenInstr
+{
+   uint64_t address;
+   uint64_t icode;
+   uint64_t ifun;
+   uint64_t rA;
+   uint64_t rB;
+   uint64_t valC;
+};
+
+//generates a random Y86-64 program in the .yo format the Loader
+//accepts. The same configuration always gives the same program.
+//The program runs the same on every engine: it sets up %rsp and the
+//address of its data in %rbp, keeps a loop counter in %r14 and a
+//data offset in %r12, and pads loads, conditional jump targets and
+//rets with nops because the pipeline does not stall or squash for
+//those hazards. Every loop ends, so the program always halts.
+class Generator
+{
+   private:
+      GenConfig config;
+      std::mt19937_64 random;
+      std::vector<GenInstr> code;
+      std::vector<uint64_t> dataRefs;   //instructions whose valC is the data address
+      std::vector<uint64_t> functions;  //addresses of the leaf functions
+      uint64_t pc;
+      uint64_t pick(uint64_t limit);
+      uint64_t workRegister();
+      uint64_t emit(uint64_t icode, uint64_t ifun, uint64_t rA,
+                    uint64_t rB, uint64_t valC);
+      void nop();
+      void aluBlock();
+      void memoryBlock();
+      void callBlock();
+      void loopBlock();
+      void block(bool loops, bool calls);
+      static std::string text(const GenInstr & instr);
+      static std::string line(uint64_t address, const std::string & bytes,
+                              const std::string & comment);
+   public:
+      Generator(const GenConfig & config);
+      static bool valid(const GenConfig & config);
+      std::string generate();
+};
+#endif
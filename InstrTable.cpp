@@ -0,0 +1,301 @@
+#include <cstdint>
+#include "Instructions.h"
+#include "Tools.h"
+#include "InstrTable.h"
+
+/*
+ * The InstrTable holds one InstrProps entry for every (icode, ifun)
+ * pair. The entries are computed at compile time by the constexpr
+ * make method so each stage replaces its chain of icode comparisons
+ * by a single table index. Both ISAs have a table; setExtended picks
+ * the one lookup uses. In the base table the extended icodes behave
+ * like any other undefined icode and the extended OPq functions have
+ * alufun ALUNONE, so the base ISA is unchanged. xchgq is the atomic
+ * exchange of the extended ISA: the memory stage reads the word at
+ * valE and writes valA to it in the same cycle, and rA receives the
+ * word read.
+ */
+
+//points to the table of the selected ISA
+const InstrProps * InstrTable::table = InstrTable::baseTable;
+
+/*
+ * maxOp
+ * @return largest OPq function of the ISA
+ */
+constexpr uint64_t InstrTable::maxOp(bool extended)
+{
+   return extended ? SHRQ : XORQ;
+}
+
+/*
+ * needRegIds
+ * @return true if the instruction has a register specifier byte
+ */
+constexpr bool InstrTable::needRegIds(uint64_t icode)
+{
+   return icode == IRRMOVQ || icode == IOPQ || icode == IPUSHQ ||
+          icode == IPOPQ || icode == IIRMOVQ || icode == IRMMOVQ ||
+          icode == IMRMOVQ || icode == IIADDQ || icode == IXCHGQ;
+}
+
+/*
+ * needValC
+ * @return true if the instruction has an 8-byte constant word
+ */
+constexpr bool InstrTable::needValC(uint64_t icode)
+{
+   return icode == IIRMOVQ || icode == IRMMOVQ || icode == IMRMOVQ ||
+          icode == IJXX || icode == ICALL || icode == IIADDQ ||
+          icode == IXCHGQ;
+}
+
+/*
+ * valid
+ * @return true if (icode, ifun) is a defined instruction of the ISA
+ */
+constexpr bool InstrTable::valid(uint64_t icode, uint64_t ifun,
+                                 bool extended)
+{
+   return (icode == IOPQ) ? ifun <= maxOp(extended) :
+          (icode == IJXX || icode == ICMOVXX) ? ifun <= GREATER :
+          (icode <= IPOPQ || icode == IIADDQ || icode == ILEAVE ||
+           icode == IXCHGQ) ? ifun == FNONE : false;
+}
+
+/*
+ * srcA
+ * @return register selector for d_srcA
+ */
+constexpr uint8_t InstrTable::srcA(uint64_t icode)
+{
+   return (icode == IRRMOVQ || icode == IRMMOVQ || icode == IOPQ ||
+           icode == IPUSHQ || icode == IXCHGQ) ? SELRA :
+          (icode == IPOPQ || icode == IRET) ? SELRSP :
+          (icode == ILEAVE) ? SELRBP : SELNONE;
+}
+
+/*
+ * srcB
+ * @return register selector for d_srcB
+ */
+constexpr uint8_t InstrTable::srcB(uint64_t icode)
+{
+   return (icode == IOPQ || icode == IRMMOVQ || icode == IMRMOVQ ||
+           icode == IIADDQ || icode == IXCHGQ) ? SELRB :
+          (icode == IPUSHQ || icode == IPOPQ || icode == ICALL ||
+           icode == IRET) ? SELRSP :
+          (icode == ILEAVE) ? SELRBP : SELNONE;
+}
+
+/*
+ * dstE
+ * @return register selector for d_dstE
+ */
+constexpr uint8_t InstrTable::dstE(uint64_t icode)
+{
+   return (icode == IRRMOVQ || icode == IIRMOVQ || icode == IOPQ ||
+           icode == IIADDQ) ? SELRB :
+          (icode == IPUSHQ || icode == IPOPQ || icode == ICALL ||
+           icode == IRET || icode == ILEAVE) ? SELRSP : SELNONE;
+}
+
+/*
+ * dstM
+ * @return register selector for d_dstM
+ */
+constexpr uint8_t InstrTable::dstM(uint64_t icode)
+{
+   return (icode == IMRMOVQ || icode == IPOPQ || icode == IXCHGQ) ? SELRA :
+          (icode == ILEAVE) ? SELRBP : SELNONE;
+}
+
+/*
+ * aluA
+ * @return selector for the aluA input of the ALU
+ */
+constexpr uint8_t InstrTable::aluA(uint64_t icode)
+{
+   return (icode == IRRMOVQ || icode == IOPQ) ? ALUAVALA :
+          (icode == IIRMOVQ || icode == IRMMOVQ || icode == IMRMOVQ ||
+           icode == IIADDQ || icode == IXCHGQ) ? ALUAVALC :
+          (icode == ICALL || icode == IPUSHQ) ? ALUANEG8 :
+          (icode == IRET || icode == IPOPQ || icode == ILEAVE) ? ALUAPOS8 :
+          ALUAZERO;
+}
+
+/*
+ * aluB
+ * @return selector for the aluB input of the ALU
+ */
+constexpr uint8_t InstrTable::aluB(uint64_t icode)
+{
+   return (icode == IRMMOVQ || icode == IMRMOVQ || icode == IOPQ ||
+           icode == ICALL || icode == IPUSHQ || icode == IRET ||
+           icode == IPOPQ || icode == IIADDQ || icode == ILEAVE ||
+           icode == IXCHGQ) ? ALUBVALB : ALUBZERO;
+}
+
+/*
+ * memAddr
+ * @return selector for the address used by the memory stage
+ */
+constexpr uint8_t InstrTable::memAddr(uint64_t icode)
+{
+   return (icode == IRMMOVQ || icode == IPUSHQ || icode == ICALL ||
+           icode == IMRMOVQ || icode == IXCHGQ) ? MADDRVALE :
+          (icode == IPOPQ || icode == IRET || icode == ILEAVE) ? MADDRVALA :
+          MADDRNONE;
+}
+
+/*
+ * make
+ * builds the InstrProps entry for a single (icode, ifun) pair; the
+ * extended icodes are built as the undefined icode 0xF in the base ISA
+ *
+ * @param icode - instruction code
+ * @param ifun - instruction function
+ * @param extended - true for the extended ISA
+ * @return the properties of the instruction
+ */
+constexpr InstrProps InstrTable::make(uint64_t icode, uint64_t ifun,
+                                      bool extended)
+{
+   return !extended && (icode == IIADDQ || icode == ILEAVE ||
+                        icode == IXCHGQ) ?
+      make(0xF, ifun, false) :
+      InstrProps {
+      valid(icode, ifun, extended),
+      needRegIds(icode),
+      needValC(icode),
+      (uint8_t) (1 + needRegIds(icode) + 8 * needValC(icode)),
+      icode == IJXX || icode == ICALL,
+      srcA(icode),
+      srcB(icode),
+      dstE(icode),
+      dstM(icode),
+      icode == IJXX || icode == ICALL,
+      aluA(icode),
+      aluB(icode),
+      (uint8_t) (icode != IOPQ ? ADDQ :
+                 ifun <= maxOp(extended) ? ifun : ALUNONE),
+      icode == IOPQ || icode == IIADDQ,
+      icode == IJXX || icode == ICMOVXX,
+      memAddr(icode),
+      icode == IMRMOVQ || icode == IPOPQ || icode == IRET ||
+         icode == ILEAVE || icode == IXCHGQ,
+      icode == IRMMOVQ || icode == IPUSHQ || icode == ICALL ||
+         icode == IXCHGQ
+   };
+}
+
+#define PROPS_ROW(icode, ext) \
+   make(icode, 0x0, ext), make(icode, 0x1, ext), make(icode, 0x2, ext), \
+   make(icode, 0x3, ext), make(icode, 0x4, ext), make(icode, 0x5, ext), \
+   make(icode, 0x6, ext), make(icode, 0x7, ext), make(icode, 0x8, ext), \
+   make(icode, 0x9, ext), make(icode, 0xa, ext), make(icode, 0xb, ext), \
+   make(icode, 0xc, ext), make(icode, 0xd, ext), make(icode, 0xe, ext), \
+   make(icode, 0xf, ext)
+
+#define PROPS_TABLE(ext) \
+   PROPS_ROW(0x0, ext), PROPS_ROW(0x1, ext), PROPS_ROW(0x2, ext), \
+   PROPS_ROW(0x3, ext), PROPS_ROW(0x4, ext), PROPS_ROW(0x5, ext), \
+   PROPS_ROW(0x6, ext), PROPS_ROW(0x7, ext), PROPS_ROW(0x8, ext), \
+   PROPS_ROW(0x9, ext), PROPS_ROW(0xa, ext), PROPS_ROW(0xb, ext), \
+   PROPS_ROW(0xc, ext), PROPS_ROW(0xd, ext), PROPS_ROW(0xe, ext), \
+   PROPS_ROW(0xf, ext)
+
+//indexed by (icode << 4) | ifun
+const InstrProps InstrTable::baseTable[NUMINSTRPROPS] = { PROPS_TABLE(false) };
+const InstrProps InstrTable::extTable[NUMINSTRPROPS] = { PROPS_TABLE(true) };
+
+//indexed by ifun
+const uint8_t InstrTable::condTable[16] = {
+   condMask(0x0), condMask(0x1), condMask(0x2), condMask(0x3),
+   condMask(0x4), condMask(0x5), condMask(0x6), condMask(0x7),
+   condMask(0x8), condMask(0x9), condMask(0xa), condMask(0xb),
+   condMask(0xc), condMask(0xd), condMask(0xe), condMask(0xf)
+};
+
+static_assert(InstrTable::make(IRMMOVQ, FNONE, false).length == 10,
+              "instruction properties must be computed at compile time");
+static_assert(!InstrTable::make(IIADDQ, FNONE, false).valid &&
+              InstrTable::make(IIADDQ, FNONE, true).length == 10,
+              "iaddq must only be defined in the extended ISA");
+static_assert(!InstrTable::make(IXCHGQ, FNONE, false).valid &&
+              InstrTable::make(IXCHGQ, FNONE, true).memRead &&
+              InstrTable::make(IXCHGQ, FNONE, true).memWrite,
+              "xchgq must read and write memory in the extended ISA");
+
+/*
+ * setExtended
+ * selects the ISA used by lookup
+ *
+ * @param extended - true for the extended ISA, false for the base ISA
+ */
+void InstrTable::setExtended(bool extended)
+{
+   table = extended ? extTable : baseTable;
+}
+
+/*
+ * isExtended
+ * @return true if the extended ISA is selected
+ */
+bool InstrTable::isExtended()
+{
+   return table == extTable;
+}
+
+/*
+ * alu
+ * computes the result of an OPq, iaddq or address calculation:
+ * opB op opA for the ALU function alufun. divq and modq divide
+ * signed and give 0 for a zero divisor (and wrap for the minimum
+ * value divided by -1); the shifts use the low 6 bits of opA.
+ *
+ * @return the result, or 0 for an undefined alufun
+ */
+uint64_t InstrTable::alu(uint64_t opA, uint64_t opB, uint64_t alufun)
+{
+   int64_t a = (int64_t) opA;
+   int64_t b = (int64_t) opB;
+   bool wraps = b == INT64_MIN && a == -1;
+
+   switch (alufun)
+   {
+      case ADDQ: return opB + opA;
+      case SUBQ: return opB - opA;
+      case ANDQ: return opA & opB;
+      case XORQ: return opA ^ opB;
+      case MULQ: return opB * opA;
+      case DIVQ: return a == 0 ? 0 : wraps ? opB : (uint64_t) (b / a);
+      case MODQ: return a == 0 || wraps ? 0 : (uint64_t) (b % a);
+      case SALQ: return opB << (opA & 63);
+      case SARQ: return (uint64_t) (b >> (opA & 63));
+      case SHRQ: return opB >> (opA & 63);
+      default: return 0;
+   }
+}
+
+/*
+ * overflow
+ * computes the OF condition code set by an operation: signed
+ * overflow for addq, subq and mulq, cleared by divq, modq and the
+ * shifts and unchanged by andq, xorq and an undefined alufun
+ *
+ * @param of - value of OF before the operation
+ * @return new value of OF
+ */
+bool InstrTable::overflow(uint64_t opA, uint64_t opB, uint64_t alufun,
+                          bool of)
+{
+   switch (alufun)
+   {
+      case ADDQ: return Tools::addOverflow(opA, opB);
+      case SUBQ: return Tools::subOverflow(opA, opB);
+      case MULQ: return Tools::mulOverflow(opA, opB);
+      case DIVQ: case MODQ: case SALQ: case SARQ: case SHRQ: return false;
+      default: return of;
+   }
+}
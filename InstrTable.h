@@ -0,0 +1,156 @@
+#include <cstdint>
+#include "Instructions.h"
+#ifndef INSTRTABLE_H
+#define INSTRTABLE_H
+
+//number of entries in the property table: one per (icode, ifun) pair
+#define NUMINSTRPROPS 256
+
+//register selectors used by srcA, srcB, dstE and dstM
+#define SELNONE 0    //RNONE
+#define SELRA 1      //rA field of the instruction
+#define SELRB 2      //rB field of the instruction
+#define SELRSP 3     //%rsp
+#define SELRBP 4     //%rbp (leave)
+#define NUMREGSEL 5
+
+//aluA selectors
+#define ALUAZERO 0   //0
+#define ALUAVALA 1   //valA
+#define ALUAVALC 2   //valC
+#define ALUANEG8 3   //-8
+#define ALUAPOS8 4   //8
+#define NUMALUASEL 5
+
+//aluB selectors
+#define ALUBZERO 0   //0
+#define ALUBVALB 1   //valB
+#define NUMALUBSEL 2
+
+//memory address selectors
+#define MADDRNONE 0  //0
+#define MADDRVALE 1  //valE
+#define MADDRVALA 2  //valA
+#define NUMMADDRSEL 3
+
+//properties of a single (icode, ifun) pair; every field is a small
+//integer so that the stages can use it to index a table of
+//candidate values instead of comparing icodes
+struct InstrProps
+{
+   uint8_t valid;       //1 if (icode, ifun) is a defined instruction
+   uint8_t needRegIds;  //1 if the instruction has a register byte
+   uint8_t needValC;    //1 if the instruction has an 8-byte constant
+   uint8_t length;      //number of bytes in the instruction
+   uint8_t predValC;    //1 if the predicted PC is valC rather than valP
+   uint8_t srcA;        //SEL* selector for d_srcA
+   uint8_t srcB;        //SEL* selector for d_srcB
+   uint8_t dstE;        //SEL* selector for d_dstE
+   uint8_t dstM;        //SEL* selector for d_dstM
+   uint8_t selValP;     //1 if d_valA is valP (jXX, call)
+   uint8_t aluA;        //ALUA* selector
+   uint8_t aluB;        //ALUB* selector
+   uint8_t alufun;      //ALU function (ADDQ, SUBQ, ...)
+   uint8_t setCC;       //1 if the condition codes are updated
+   uint8_t useCond;     //1 if the instruction is conditional (jXX, cmovXX)
+   uint8_t memAddr;     //MADDR* selector
+   uint8_t memRead;     //1 if the memory stage reads memory
+   uint8_t memWrite;    //1 if the memory stage writes memory
+};
+
+//constexpr-generated table of instruction properties shared by
+//the FetchStage, DecodeStage, ExecuteStage and MemoryStage. There is
+//a table for the base Y86-64 ISA (the default) and one for the
+//extended ISA that adds iaddq, leave, xchgq and the mulq, divq, modq,
+//salq, sarq and shrq OPq functions.
+class InstrTable
+{
+   private:
+      static const InstrProps baseTable[NUMINSTRPROPS];
+      static const InstrProps extTable[NUMINSTRPROPS];
+      static const InstrProps * table;    //baseTable or extTable
+      static const uint8_t condTable[16];
+      static constexpr uint64_t maxOp(bool extended);
+      static constexpr bool needRegIds(uint64_t icode);
+      static constexpr bool needValC(uint64_t icode);
+      static constexpr bool valid(uint64_t icode, uint64_t ifun, bool extended);
+      static constexpr uint8_t srcA(uint64_t icode);
+      static constexpr uint8_t srcB(uint64_t icode);
+      static constexpr uint8_t dstE(uint64_t icode);
+      static constexpr uint8_t dstM(uint64_t icode);
+      static constexpr uint8_t aluA(uint64_t icode);
+      static constexpr uint8_t aluB(uint64_t icode);
+      static constexpr uint8_t memAddr(uint64_t icode);
+      static constexpr bool condHolds(uint64_t ifun, bool zf, bool sf, bool of);
+   public:
+      static constexpr InstrProps make(uint64_t icode, uint64_t ifun,
+                                       bool extended);
+      static constexpr uint8_t condMask(uint64_t ifun);
+      static const InstrProps & lookup(uint64_t icode, uint64_t ifun);
+      static uint64_t cond(uint64_t ifun, bool zf, bool sf, bool of);
+      static void setExtended(bool extended);
+      static bool isExtended();
+      static uint64_t alu(uint64_t opA, uint64_t opB, uint64_t alufun);
+      static bool overflow(uint64_t opA, uint64_t opB, uint64_t alufun,
+                           bool of);
+};
+
+/*
+ * lookup
+ * returns the properties of the instruction with the given icode and ifun
+ *
+ * @param icode - instruction code (only the low 4 bits are used)
+ * @param ifun - instruction function (only the low 4 bits are used)
+ * @return reference to the table entry for (icode, ifun)
+ */
+inline const InstrProps & InstrTable::lookup(uint64_t icode, uint64_t ifun)
+{
+   return table[((icode & 0xf) << 4) | (ifun & 0xf)];
+}
+
+/*
+ * cond
+ * evaluates the jXX/cmovXX condition selected by ifun without branching
+ * on ifun: each condTable entry holds the truth table of the condition
+ * indexed by the three condition code bits
+ *
+ * @param ifun - condition (UNCOND, LESSEQ, ...)
+ * @param zf, sf, of - values of the condition codes
+ * @return 1 if the condition holds and 0 otherwise
+ */
+inline uint64_t InstrTable::cond(uint64_t ifun, bool zf, bool sf, bool of)
+{
+   return (condTable[ifun & 0xf] >> (zf | (sf << 1) | (of << 2))) & 1;
+}
+
+/*
+ * condHolds
+ * @return true if condition ifun holds for the given condition codes
+ */
+constexpr bool InstrTable::condHolds(uint64_t ifun, bool zf, bool sf, bool of)
+{
+   return ifun == UNCOND ? true :
+          ifun == LESSEQ ? (sf ^ of) | zf :
+          ifun == LESS ? sf ^ of :
+          ifun == EQUAL ? zf :
+          ifun == NOTEQUAL ? !zf :
+          ifun == GREATEREQ ? !(sf ^ of) :
+          ifun == GREATER ? !(sf ^ of) & !zf : false;
+}
+
+/*
+ * condMask
+ * builds the truth table of condition ifun; bit (zf | sf << 1 | of << 2)
+ * of the result is 1 if the condition holds for those condition codes
+ *
+ * @param ifun - condition (UNCOND, LESSEQ, ...)
+ * @return 8-bit truth table
+ */
+constexpr uint8_t InstrTable::condMask(uint64_t ifun)
+{
+   return condHolds(ifun, 0, 0, 0) << 0 | condHolds(ifun, 1, 0, 0) << 1 |
+          condHolds(ifun, 0, 1, 0) << 2 | condHolds(ifun, 1, 1, 0) << 3 |
+          condHolds(ifun, 0, 0, 1) << 4 | condHolds(ifun, 1, 0, 1) << 5 |
+          condHolds(ifun, 0, 1, 1) << 6 | condHolds(ifun, 1, 1, 1) << 7;
+}
+#endif
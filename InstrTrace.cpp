@@ -0,0 +1,129 @@
+#include <fstream>
+#include <cstdint>
+#include <string.h>
+#include "Memory.h"
+#include "RegisterFile.h"
+#include "Status.h"
+#include "Tools.h"
+#include "Executor.h"
+#include "PipeReg.h"
+#include "ReplayLog.h"
+#include "InstrTrace.h"
+
+/*
+ * Trace file layout:
+ *   "YESSTRC1"
+ *   one record per instruction:
+ *     icode << 4 | ifun
+ *     stat | load << 3 | store << 4 | taken << 5 | redirect << 6
+ *     numRegs << 4 | numDests
+ *     the registers read, the registers written and loaded, a nibble
+ *     each (low nibble first), padded to a whole byte; RNONE is never
+ *     read or written, so 0xf stands for the condition codes (EXECCCREG)
+ *     in the registers read and written and for RNONE in loaded
+ *     pc, then the address if the instruction loads or stores, as
+ *     LEB128 varints
+ * The last record is the first instruction whose status is not SAOK.
+ */
+
+/*
+ * writeRecord
+ * appends the record of the instruction r to out
+ */
+void InstrTrace::writeRecord(std::ostream & out, const InstrRecord & r)
+{
+   uint8_t nibbles[EXECMAXREADS + EXECMAXWRITES + 1];
+   uint64_t count = 0;
+   for (uint64_t i = 0; i < r.numRegs; i++) nibbles[count++] = r.reg[i];
+   for (uint64_t i = 0; i < r.numDests; i++) nibbles[count++] = r.dest[i];
+   for (uint64_t i = 0; i < count; i++)
+      if (nibbles[i] == EXECCCREG) nibbles[i] = RNONE;
+   nibbles[count++] = r.loaded;
+
+   out.put((char) (r.icode << 4 | r.ifun));
+   out.put((char) (r.stat | r.load << 3 | r.store << 4 | r.taken << 5 |
+                   r.redirect << 6));
+   out.put((char) (r.numRegs << 4 | r.numDests));
+   for (uint64_t i = 0; i < count; i += 2)
+      out.put((char) (nibbles[i] | (i + 1 < count ? nibbles[i + 1] << 4 : 0)));
+   ReplayLog::writeVarint(out, r.pc);
+   if (r.load || r.store) ReplayLog::writeVarint(out, r.addr);
+}
+
+/*
+ * record
+ * executes the program in Memory from address 0 until a halt or an
+ * instruction with an error status and writes the trace of the
+ * instructions to fileName
+ *
+ * @return false if the file cannot be written
+ */
+bool InstrTrace::record(const char * fileName)
+{
+   std::ofstream out(fileName, std::ios::binary);
+   if (!out.is_open()) return false;
+
+   Executor executor;
+   InstrRecord r;
+   out.write("YESSTRC1", LONGSIZE);
+   do
+   {
+      executor.step(r);
+      writeRecord(out, r);
+   } while (r.stat == SAOK);
+   return out.good();
+}
+
+/*
+ * open
+ * starts reading the trace in fileName
+ *
+ * @return false if the file cannot be read or is not a trace
+ */
+bool InstrTrace::open(const char * fileName)
+{
+   char magic[LONGSIZE];
+   in.open(fileName, std::ios::binary);
+   return in.read(magic, LONGSIZE) && memcmp(magic, "YESSTRC1", LONGSIZE) == 0;
+}
+
+/*
+ * next
+ * reads the record of the next instruction of the trace into r
+ *
+ * @return false at the end of the trace or on a malformed record
+ */
+bool InstrTrace::next(InstrRecord & r)
+{
+   uint8_t bytes[3];
+   uint8_t nibbles[EXECMAXREADS + EXECMAXWRITES + 2];
+   if (!in.read((char *) bytes, 3)) return false;
+   r.icode = bytes[0] >> 4;
+   r.ifun = bytes[0] & 0xf;
+   r.stat = bytes[1] & 0x7;
+   r.load = bytes[1] >> 3 & 1;
+   r.store = bytes[1] >> 4 & 1;
+   r.taken = bytes[1] >> 5 & 1;
+   r.redirect = bytes[1] >> 6 & 1;
+   r.numRegs = bytes[2] >> 4;
+   r.numDests = bytes[2] & 0xf;
+   if (r.numRegs > EXECMAXREADS || r.numDests > EXECMAXWRITES) return false;
+
+   uint64_t count = r.numRegs + r.numDests + 1;
+   for (uint64_t i = 0; i < count; i += 2)
+   {
+      int byte = in.get();
+      if (byte == EOF) return false;
+      nibbles[i] = byte & 0xf;
+      nibbles[i + 1] = byte >> 4;
+   }
+   for (uint64_t i = 0; i < count - 1; i++)
+      if (nibbles[i] == RNONE) nibbles[i] = EXECCCREG;
+   for (uint64_t i = 0; i < r.numRegs; i++) r.reg[i] = nibbles[i];
+   for (uint64_t i = 0; i < r.numDests; i++) r.dest[i] = nibbles[r.numRegs + i];
+   r.loaded = nibbles[count - 1];
+
+   r.addr = 0;
+   if (!ReplayLog::readVarint(in, r.pc)) return false;
+   return !(r.load || r.store) || ReplayLog::readVarint(in, r.addr);
+}
@@ -0,0 +1,21 @@
+#include <cstdint>
+#include <fstream>
+#include "Executor.h"
+#ifndef INSTRTRACE_H
+#define INSTRTRACE_H
+
+//trace of the instructions a program executes, in program order, as
+//the InstrRecords an Executor describes them with. A trace is written
+//once and read any number of times by timing models, which then need
+//neither the program nor its data.
+class InstrTrace
+{
+   private:
+      std::ifstream in;
+      static void writeRecord(std::ostream & out, const InstrRecord & r);
+   public:
+      static bool record(const char * fileName);
+      bool open(const char * fileName);
+      bool next(InstrRecord & r);
+};
+#endif
@@ -13,11 +13,24 @@
 #define IRET 9
 #define IPUSHQ 0xA
 #define IPOPQ 0xB
+//extended ISA only (InstrTable::setExtended)
+#define IIADDQ 0xC
+#define ILEAVE 0xD
+#define IXCHGQ 0xE
 
 #define ADDQ 0
 #define SUBQ 1
 #define ANDQ 2
 #define XORQ 3
+//extended ISA only (InstrTable::setExtended)
+#define MULQ 4
+#define DIVQ 5
+#define MODQ 6
+#define SALQ 7
+#define SARQ 8
+#define SHRQ 9
+//alufun of an OPq whose ifun is not defined; the ALU returns 0
+#define ALUNONE 0xF
 
 #define UNCOND 0
 #define LESSEQ 1
@@ -0,0 +1,550 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+#include "Memory.h"
+#include "RegisterFile.h"
+#include "ConditionCodes.h"
+#include "Instructions.h"
+#include "Status.h"
+#include "Tools.h"
+#include "InstrTable.h"
+#include "Interpreter.h"
+
+/*
+ * The Interpreter executes the program in Memory one instruction at
+ * a time without modeling the pipeline. Each address is decoded the
+ * first time control reaches it into a ThreadedInstr that holds the
+ * address of its handler, so dispatching the next instruction is a
+ * single indirect jump (GCC computed goto; other compilers, or a build
+ * with SWITCHDISPATCH defined, jump back to a switch). Common pairs (irmovq + OPq, mrmovq + OPq, OPq + jXX) are
+ * fused into superinstructions that take one dispatch. A store
+ * discards the decoded entries that overlap the stored bytes.
+ */
+
+#if defined(__GNUC__) && !defined(SWITCHDISPATCH)
+#define THREADED 1
+#endif
+
+#ifdef THREADED
+#define HANDLER(op, label) label:
+#define NEXT() do { if (instructions >= limit) goto done; \
+                        d = &code[pc]; dispatches++; goto *d->handler; } while (0)
+#else
+#define HANDLER(op, label) case op:
+#define NEXT() goto dispatch
+#endif
+
+//transfers control to target, stopping with SADR if it is out of range
+#define JUMP(target) do { pc = (target); \
+                          if (pc >= MEMSIZE) { stat = SADR; goto done; } \
+                          NEXT(); } while (0)
+
+/*
+ * Interpreter constructor
+ */
+Interpreter::Interpreter()
+{
+   handlers = NULL;
+   mem = Memory::getInstance();
+   rf = RegisterFile::getInstance();
+   cc = ConditionCodes::getInstance();
+   stat = SAOK;
+   pc = 0;
+   dispatches = 0;
+   instructions = 0;
+   fused = 0;
+   limit = UINT64_MAX;
+   seconds = 0;
+}
+
+/*
+ * run
+ * executes the program starting at address 0 until the status is
+ * no longer SAOK
+ */
+void Interpreter::run()
+{
+   reset();
+   runFor(UINT64_MAX);
+}
+
+/*
+ * reset
+ * restarts execution at address 0 and forgets all decoded instructions
+ */
+void Interpreter::reset()
+{
+   stat = SAOK;
+   pc = 0;
+   invalidate(0, MEMSIZE);
+}
+
+/*
+ * runFor
+ * continues execution from the current PC until the status is no
+ * longer SAOK or at least maxInstructions more instructions have been
+ * executed (a superinstruction can finish one instruction past the
+ * limit)
+ *
+ * @param maxInstructions - number of instructions to execute
+ * @return number of instructions executed
+ */
+uint64_t Interpreter::runFor(uint64_t maxInstructions)
+{
+#ifdef THREADED
+   static const void * const labels[NUMOPS] = {
+      &&undecoded, &&badaddr, &&invalid, &&halt, &&nop, &&rrmovq,
+      &&cmovxx, &&irmovq, &&rmmovq, &&mrmovq, &&opq, &&jmp, &&jxx,
+      &&call, &&ret, &&pushq, &&popq, &&irmovqopq, &&mrmovqopq,
+      &&opqjxx, &&iaddq, &&leave, &&xchgq
+   };
+   if (handlers == NULL)
+   {
+      handlers = labels;
+      invalidate(0, MEMSIZE);
+   }
+#endif
+   if (stat != SAOK) return 0;
+
+   std::chrono::steady_clock::time_point start =
+      std::chrono::steady_clock::now();
+   ThreadedInstr * d;
+   uint64_t value, rsp, addr;
+   uint64_t first = instructions;
+   limit = maxInstructions < UINT64_MAX - instructions ?
+           instructions + maxInstructions : UINT64_MAX;
+
+#ifdef THREADED
+   NEXT();
+#else
+dispatch:
+   if (instructions >= limit) goto done;
+   d = &code[pc];
+   dispatches++;
+   switch (d->op)
+   {
+#endif
+      HANDLER(OPUNDECODED, undecoded)
+         predecode(pc);
+         dispatches--;
+         NEXT();
+      HANDLER(OPBADADDR, badaddr)
+         stat = SADR;
+         goto done;
+      HANDLER(OPINVALID, invalid)
+         stat = SINS;
+         goto done;
+      HANDLER(OPHALT, halt)
+         instructions++;
+         stat = SHLT;
+         goto done;
+      HANDLER(OPNOP, nop)
+         instructions++;
+         pc = d->valP;
+         NEXT();
+      HANDLER(OPRRMOVQ, rrmovq)
+         writeReg(readReg(d->rA), d->rB);
+         instructions++;
+         pc = d->valP;
+         NEXT();
+      HANDLER(OPCMOVXX, cmovxx)
+         if (condition(d->ifun)) writeReg(readReg(d->rA), d->rB);
+         instructions++;
+         pc = d->valP;
+         NEXT();
+      HANDLER(OPIRMOVQ, irmovq)
+         writeReg(d->valC, d->rB);
+         instructions++;
+         pc = d->valP;
+         NEXT();
+      HANDLER(OPRMMOVQ, rmmovq)
+         if (!store(readReg(d->rB) + d->valC, readReg(d->rA)))
+         {
+            stat = SADR;
+            goto done;
+         }
+         instructions++;
+         pc = d->valP;
+         NEXT();
+      HANDLER(OPMRMOVQ, mrmovq)
+         if (!load(readReg(d->rB) + d->valC, value))
+         {
+            stat = SADR;
+            goto done;
+         }
+         writeReg(value, d->rA);
+         instructions++;
+         pc = d->valP;
+         NEXT();
+      HANDLER(OPOPQ, opq)
+         opq(d->ifun, d->rA, d->rB);
+         instructions++;
+         pc = d->valP;
+         NEXT();
+      HANDLER(OPJMP, jmp)
+         instructions++;
+         JUMP(d->valC);
+      HANDLER(OPJXX, jxx)
+         instructions++;
+         JUMP(condition(d->ifun) ? d->valC : d->valP);
+      HANDLER(OPCALL, call)
+         rsp = readReg(RSP) - 8;
+         if (!store(rsp, d->valP))
+         {
+            stat = SADR;
+            goto done;
+         }
+         writeReg(rsp, RSP);
+         instructions++;
+         JUMP(d->valC);
+      HANDLER(OPRET, ret)
+         rsp = readReg(RSP);
+         if (!load(rsp, value))
+         {
+            stat = SADR;
+            goto done;
+         }
+         writeReg(rsp + 8, RSP);
+         instructions++;
+         JUMP(value);
+      HANDLER(OPPUSHQ, pushq)
+         value = readReg(d->rA);
+         rsp = readReg(RSP) - 8;
+         if (!store(rsp, value))
+         {
+            stat = SADR;
+            goto done;
+         }
+         writeReg(rsp, RSP);
+         instructions++;
+         pc = d->valP;
+         NEXT();
+      HANDLER(OPPOPQ, popq)
+         rsp = readReg(RSP);
+         if (!load(rsp, value))
+         {
+            stat = SADR;
+            goto done;
+         }
+         writeReg(rsp + 8, RSP);
+         writeReg(value, d->rA);
+         instructions++;
+         pc = d->valP;
+         NEXT();
+      HANDLER(OPIRMOVQOPQ, irmovqopq)
+         writeReg(d->valC, d->rB);
+         opq(d->ifun2, d->rA2, d->rB2);
+         instructions += 2;
+         fused++;
+         pc = d->valP;
+         NEXT();
+      HANDLER(OPMRMOVQOPQ, mrmovqopq)
+         if (!load(readReg(d->rB) + d->valC, value))
+         {
+            stat = SADR;
+            goto done;
+         }
+         writeReg(value, d->rA);
+         opq(d->ifun2, d->rA2, d->rB2);
+         instructions += 2;
+         fused++;
+         pc = d->valP;
+         NEXT();
+      HANDLER(OPOPQJXX, opqjxx)
+         opq(d->ifun, d->rA, d->rB);
+         instructions += 2;
+         fused++;
+         JUMP(condition(d->ifun2) ? d->valC2 : d->valP);
+      HANDLER(OPIADDQ, iaddq)
+         arith(ADDQ, d->valC, d->rB);
+         instructions++;
+         pc = d->valP;
+         NEXT();
+      HANDLER(OPLEAVE, leave)
+         rsp = readReg(RBP);
+         if (!load(rsp, value))
+         {
+            stat = SADR;
+            goto done;
+         }
+         writeReg(rsp + 8, RSP);
+         writeReg(value, RBP);
+         instructions++;
+         pc = d->valP;
+         NEXT();
+      HANDLER(OPXCHGQ, xchgq)
+         addr = readReg(d->rB) + d->valC;
+         if (!load(addr, value) || !store(addr, readReg(d->rA)))
+         {
+            stat = SADR;
+            goto done;
+         }
+         writeReg(value, d->rA);
+         instructions++;
+         pc = d->valP;
+         NEXT();
+#ifndef THREADED
+   }
+#endif
+
+done:
+   seconds += std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - start).count();
+   return instructions - first;
+}
+
+/*
+ * decodeOne
+ * decodes the single instruction at addr
+ *
+ * @param addr - address of the instruction
+ * @param instr - set to the decoded instruction
+ * @return true if addr holds a valid instruction
+ */
+bool Interpreter::decodeOne(uint64_t addr, ThreadedInstr & instr)
+{
+   bool error = false;
+   uint8_t byte = mem->getByte(addr, error);
+   uint64_t icode = byte >> 4;
+   uint64_t ifun = byte & 0xf;
+   const InstrProps & props = InstrTable::lookup(icode, ifun);
+
+   instr.op = OPBADADDR;
+   if (error) return false;
+   instr.op = OPINVALID;
+   if (!props.valid) return false;
+   instr.op = OPBADADDR;
+   if (addr + props.length > MEMSIZE) return false;
+
+   uint8_t regs = props.needRegIds ? mem->getByte(addr + 1, error) : 0xff;
+   instr.ifun = ifun;
+   instr.rA = regs >> 4;
+   instr.rB = regs & 0xf;
+   instr.valC = 0;
+   for (int32_t i = 0; props.needValC && i < LONGSIZE; i++)
+      instr.valC |= (uint64_t) mem->getByte(addr + 1 + props.needRegIds + i,
+                                            error) << (8 * i);
+   instr.valP = addr + props.length;
+
+   uint8_t ops[16] = {OPHALT, OPNOP, OPRRMOVQ, OPIRMOVQ, OPRMMOVQ,
+                      OPMRMOVQ, OPOPQ, OPJXX, OPCALL, OPRET, OPPUSHQ,
+                      OPPOPQ, OPIADDQ, OPLEAVE, OPXCHGQ, OPINVALID};
+   instr.op = ops[icode];
+   if (instr.op == OPRRMOVQ && ifun != UNCOND) instr.op = OPCMOVXX;
+   if (instr.op == OPJXX && ifun == UNCOND) instr.op = OPJMP;
+   return true;
+}
+
+/*
+ * predecode
+ * decodes the instruction at addr into code[addr], fusing it with
+ * the instruction that follows it when the pair has a superinstruction
+ *
+ * @param addr - address of the instruction
+ */
+void Interpreter::predecode(uint64_t addr)
+{
+   ThreadedInstr & instr = code[addr];
+   ThreadedInstr second;
+
+   if (decodeOne(addr, instr) && instr.valP < MEMSIZE &&
+       (instr.op == OPIRMOVQ || instr.op == OPMRMOVQ || instr.op == OPOPQ) &&
+       decodeOne(instr.valP, second))
+   {
+      bool withOpq = second.op == OPOPQ && instr.op != OPOPQ;
+      bool withJxx = (second.op == OPJXX || second.op == OPJMP) &&
+                     instr.op == OPOPQ;
+      if (withOpq || withJxx)
+      {
+         instr.op = instr.op == OPIRMOVQ ? OPIRMOVQOPQ :
+                    instr.op == OPMRMOVQ ? OPMRMOVQOPQ : OPOPQJXX;
+         instr.ifun2 = second.ifun;
+         instr.rA2 = second.rA;
+         instr.rB2 = second.rB;
+         instr.valC2 = second.valC;
+         instr.valP = second.valP;
+      }
+   }
+   if (handlers != NULL) instr.handler = handlers[instr.op];
+}
+
+/*
+ * invalidate
+ * forgets the decoded entries that could include the bytes from
+ * addr to addr + length - 1
+ *
+ * @param addr - address of the first byte that changed
+ * @param length - number of bytes that changed
+ */
+void Interpreter::invalidate(uint64_t addr, uint64_t length)
+{
+   uint64_t first = addr >= MAXFUSEDLEN - 1 ? addr - (MAXFUSEDLEN - 1) : 0;
+   for (uint64_t i = first; i < addr + length && i < MEMSIZE; i++)
+   {
+      code[i].op = OPUNDECODED;
+      if (handlers != NULL) code[i].handler = handlers[OPUNDECODED];
+   }
+}
+
+/*
+ * opq
+ * performs an OPq instruction, updating rB and the condition codes
+ * as the ExecuteStage does
+ */
+void Interpreter::opq(uint64_t ifun, uint64_t rA, uint64_t rB)
+{
+   arith(ifun, readReg(rA), rB);
+}
+
+/*
+ * arith
+ * applies ALU function ifun to opA and register rB, writing the result
+ * to rB and updating the condition codes (OPq and iaddq)
+ */
+void Interpreter::arith(uint64_t ifun, uint64_t opA, uint64_t rB)
+{
+   uint64_t opB = readReg(rB);
+   uint64_t result = InstrTable::alu(opA, opB, ifun);
+   bool error = false;
+
+   cc->setConditionCode(result == 0, ZF, error);
+   cc->setConditionCode(Tools::sign(result), SF, error);
+   cc->setConditionCode(InstrTable::overflow(opA, opB, ifun,
+                        cc->getConditionCode(OF, error)), OF, error);
+   writeReg(result, rB);
+}
+
+/*
+ * condition
+ * @return true if jXX/cmovXX condition ifun holds
+ */
+bool Interpreter::condition(uint64_t ifun)
+{
+   bool error = false;
+   return InstrTable::cond(ifun, cc->getConditionCode(ZF, error),
+                           cc->getConditionCode(SF, error),
+                           cc->getConditionCode(OF, error));
+}
+
+/*
+ * readReg
+ * @return value of register regNum, or 0 for RNONE
+ */
+uint64_t Interpreter::readReg(uint64_t regNum)
+{
+   bool error = false;
+   return rf->readRegister(regNum, error);
+}
+
+/*
+ * writeReg
+ * sets register regNum to value; writes to RNONE are discarded
+ */
+void Interpreter::writeReg(uint64_t value, uint64_t regNum)
+{
+   bool error = false;
+   rf->writeRegister(value, regNum, error);
+}
+
+/*
+ * load
+ * reads the 64-bit word at addr
+ *
+ * @return false on an address error
+ */
+bool Interpreter::load(uint64_t addr, uint64_t & value)
+{
+   bool error = addr >= MEMSIZE;
+   value = error ? 0 : mem->getLong(addr, error);
+   return !error;
+}
+
+/*
+ * store
+ * writes value to the 64-bit word at addr and forgets the decoded
+ * instructions that included those bytes
+ *
+ * @return false on an address error
+ */
+bool Interpreter::store(uint64_t addr, uint64_t value)
+{
+   bool error = addr >= MEMSIZE;
+   if (!error) mem->putLong(value, addr, error);
+   if (error) return false;
+   invalidate(addr, LONGSIZE);
+   return true;
+}
+
+/*
+ * getStat
+ * @return final status (SHLT, SADR or SINS)
+ */
+uint64_t Interpreter::getStat()
+{
+   return stat;
+}
+
+/*
+ * getPC
+ * @return address of the next instruction to execute
+ */
+uint64_t Interpreter::getPC()
+{
+   return pc;
+}
+
+/*
+ * getDispatches
+ * @return number of handler dispatches
+ */
+uint64_t Interpreter::getDispatches()
+{
+   return dispatches;
+}
+
+/*
+ * getInstructions
+ * @return number of Y86-64 instructions executed
+ */
+uint64_t Interpreter::getInstructions()
+{
+   return instructions;
+}
+
+/*
+ * getFused
+ * @return number of superinstructions dispatched
+ */
+uint64_t Interpreter::getFused()
+{
+   return fused;
+}
+
+/*
+ * getSeconds
+ * @return host time spent executing instructions
+ */
+double Interpreter::getSeconds()
+{
+   return seconds;
+}
+
+/*
+ * dump
+ * outputs the statistics of the run followed by the condition codes,
+ * register file and memory
+ */
+void Interpreter::dump()
+{
+   std::cout << "\nAt end of interpreted run:" << std::endl;
+   std::cout << "stat: " << std::hex << stat << " pc: "
+             << std::setw(3) << std::setfill('0') << pc
+             << std::dec << " instructions: " << instructions
+             << " dispatches: " << dispatches
+             << " superinstructions: " << fused << std::endl;
+   cc->dump();
+   rf->dump();
+   mem->dump();
+}
@@ -0,0 +1,91 @@
+#include <cstdint>
+#ifndef INTERPRETER_H
+#define INTERPRETER_H
+
+//handlers of the threaded interpreter; the last three are
+//superinstructions that execute two Y86-64 instructions
+#define OPUNDECODED 0
+#define OPBADADDR 1
+#define OPINVALID 2
+#define OPHALT 3
+#define OPNOP 4
+#define OPRRMOVQ 5
+#define OPCMOVXX 6
+#define OPIRMOVQ 7
+#define OPRMMOVQ 8
+#define OPMRMOVQ 9
+#define OPOPQ 10
+#define OPJMP 11
+#define OPJXX 12
+#define OPCALL 13
+#define OPRET 14
+#define OPPUSHQ 15
+#define OPPOPQ 16
+#define OPIRMOVQOPQ 17
+#define OPMRMOVQOPQ 18
+#define OPOPQJXX 19
+#define OPIADDQ 20      //extended ISA
+#define OPLEAVE 21      //extended ISA
+#define OPXCHGQ 22      //extended ISA
+#define NUMOPS 23
+
+//longest superinstruction in bytes (mrmovq + OPq)
+#define MAXFUSEDLEN 12
+
+//a predecoded instruction (or pair of instructions)
+struct ThreadedInstr
+{
+   const void * handler;   //address of the handler (computed goto)
+   uint8_t op;             //OP* handler number
+   uint8_t ifun;
+   uint8_t rA;
+   uint8_t rB;
+   uint8_t ifun2;          //fields of the second instruction of a
+   uint8_t rA2;            //superinstruction
+   uint8_t rB2;
+   uint64_t valC;
+   uint64_t valC2;
+   uint64_t valP;          //address of the following instruction
+};
+
+//predecoded, direct-threaded interpreter that executes the program
+//in Memory using the RegisterFile and ConditionCodes instances
+class Interpreter
+{
+   private:
+      ThreadedInstr code[MEMSIZE];
+      const void * const * handlers;
+      Memory * mem;
+      RegisterFile * rf;
+      ConditionCodes * cc;
+      uint64_t stat;
+      uint64_t pc;
+      uint64_t dispatches;
+      uint64_t instructions;
+      uint64_t fused;
+      uint64_t limit;         //instruction count at which runFor stops
+      double seconds;
+      void predecode(uint64_t addr);
+      void invalidate(uint64_t addr, uint64_t length);
+      bool decodeOne(uint64_t addr, ThreadedInstr & instr);
+      void opq(uint64_t ifun, uint64_t rA, uint64_t rB);
+      void arith(uint64_t ifun, uint64_t opA, uint64_t rB);
+      bool condition(uint64_t ifun);
+      uint64_t readReg(uint64_t regNum);
+      void writeReg(uint64_t value, uint64_t regNum);
+      bool load(uint64_t addr, uint64_t & value);
+      bool store(uint64_t addr, uint64_t value);
+   public:
+      Interpreter();
+      void run();
+      void reset();
+      uint64_t runFor(uint64_t maxInstructions);
+      uint64_t getStat();
+      uint64_t getPC();
+      uint64_t getDispatches();
+      uint64_t getInstructions();
+      uint64_t getFused();
+      double getSeconds();
+      void dump();
+};
+#endif
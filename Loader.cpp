@@ -6,6 +6,8 @@
 #include <algorithm>
 #include "Loader.h"
 #include "Memory.h"
+#include "Debug.h"
+#include "SymbolTable.h"
 
 #define ADDRBEGIN 2
 #define ADDREND 4
@@ -21,20 +23,75 @@
 // This method is complete and does not need to be modified.
 Loader::Loader(int argc, char *argv[])
 {
-   std::ifstream inf; // input file stream for reading from file
-   int lineNumber = 1;
    lastAddress = -1;
    loaded = false;
 
-   // if no file name given or filename badly formed, return without loading
-   if (argc < 2 || badFile(argv[1]))
+   // if no file name given, return without loading
+   if (argc < 2)
       return;
-   inf.open(argv[1]);
+   loadFile(argv[1]);
+}
+
+/*
+ * Loader
+ * loads the contents of the .yo file named fileName into memory.
+ * If the file is able to be loaded, then loaded is set to true.
+ *
+ * @param fileName - name of a .yo file
+ */
+Loader::Loader(const char * fileName)
+{
+   lastAddress = -1;
+   loaded = false;
+   loadFile(fileName);
+}
+
+/*
+ * Loader
+ * loads .yo formatted lines read from inf into memory.
+ * If all of the lines are valid, then loaded is set to true.
+ *
+ * @param inf - stream holding the contents of a .yo file
+ */
+Loader::Loader(std::istream & inf)
+{
+   lastAddress = -1;
+   loaded = false;
+   load(inf);
+}
+
+/*
+ * loadFile
+ * opens the file named fileName and loads its contents into memory
+ * if the name is a properly formed .yo filename
+ *
+ * @param fileName - name of a .yo file
+ */
+void Loader::loadFile(const char * fileName)
+{
+   std::ifstream inf; // input file stream for reading from file
+
+   // if filename badly formed, return without loading
+   if (badFile(fileName))
+      return;
+   inf.open(fileName);
 
    // if file can't be opened, return without loading
    if (!inf.is_open())
       return;
+   load(inf);
+}
 
+/*
+ * load
+ * reads the lines of a .yo file from inf and loads the data on each
+ * line into memory; stops at the first line that has an error
+ *
+ * @param inf - stream holding the contents of a .yo file
+ */
+void Loader::load(std::istream & inf)
+{
+   int lineNumber = 1;
    std::string line;
    while (getline(inf, line))
    {
@@ -46,6 +103,8 @@ Loader::Loader(int argc, char *argv[])
       }
       if (hasAddress(line) && hasData(line))
          loadLine(line);
+      if (hasAddress(line) && hasComment(line))
+         loadLabel(line);
       lineNumber++;
    }
    loaded = true;
@@ -136,6 +195,33 @@ void Loader::loadLine(std::string line)
       bool error = false;
       Memory::getInstance()->putByte(value, lastAddress, error);
    }
+   TRACE(TRACELOADER, std::cout << "loader: " << std::hex << address
+         << "-" << lastAddress << std::endl);
+}
+
+/*
+ * loadLabel
+ * The line that is passed in contains an address and a comment.
+ * If the comment starts with a label (an identifier followed by a
+ * colon, as in "| loop: addq %rax, %rbx") then the label is added
+ * to the SymbolTable with the address on the line.
+ *
+ * @param line - a string containing a line of valid input from
+ *               a .yo file
+ */
+void Loader::loadLabel(std::string line)
+{
+   uint64_t start = COMMENT + 1;
+   while (start < line.length() && line[start] == 0x20) start++;
+   uint64_t end = start;
+   while (end < line.length() && (isalnum(line[end]) || line[end] == '_' ||
+                                  line[end] == '.'))
+      end++;
+   if (end == start || isdigit(line[start]) || end >= line.length() ||
+       line[end] != ':')
+      return;
+   int32_t address = convert(line, ADDRBEGIN, ADDREND - 1);
+   SymbolTable::getInstance()->add(address, line.substr(start, end - start));
 }
 
 /*
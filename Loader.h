@@ -10,6 +10,7 @@ class Loader
       bool badFile(std::string);
       int32_t convert(std::string, int32_t, int32_t);
       void loadLine(std::string);
+      void loadLabel(std::string);
       bool hasErrors(std::string);
       bool hasAddress(std::string);
       bool hasData(std::string);
@@ -17,7 +18,11 @@ class Loader
       bool errorAddr(std::string);
       bool errorData(std::string, int32_t &);
       bool isSpaces(std::string, int32_t, int32_t);
+      void loadFile(const char * fileName);
+      void load(std::istream & inf);
    public:
       Loader(int argc, char * argv[]);
+      Loader(const char * fileName);
+      Loader(std::istream & inf);
       bool isLoaded();
 };
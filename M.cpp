@@ -22,6 +22,24 @@ M::M()
    valA = new PipeRegField();
    dstE = new PipeRegField(RNONE);
    dstM = new PipeRegField(RNONE);
+   pc = new PipeRegField(NOPC);
+}
+
+/*
+ * M destructor
+ *
+ * frees the fields of the M pipeline register
+ */
+M::~M()
+{
+   delete stat;
+   delete icode;
+   delete Cnd;
+   delete valE;
+   delete valA;
+   delete dstE;
+   delete dstM;
+   delete pc;
 }
 
 /* return the stat pipeline register field */
@@ -66,18 +84,41 @@ PipeRegField * M::getdstM()
    return dstM;
 }
 
+/* return the pc pipeline register field */
+PipeRegField * M::getpc()
+{
+   return pc;
+}
+
 /* 
  * dump
  *
- * outputs the current values of the M pipeline register
+ * outputs the current values of the M pipeline register to out
+*/
+void M::dump(std::ostream & out)
+{
+   dumpField(out, "M: stat: ", 1, stat->getOutput(), false);
+   dumpField(out, " icode: ", 1, icode->getOutput(), false);
+   dumpField(out, " Cnd: ", 1, Cnd->getOutput(), false);
+   dumpField(out, " valE: ", 16, valE->getOutput(), false);
+   dumpField(out, " valA: ", 16, valA->getOutput(), false);
+   dumpField(out, " dstE: ", 1, dstE->getOutput(), false);
+   dumpField(out, " dstM: ", 1, dstM->getOutput(), true);
+}
+
+/*
+ * reset
+ *
+ * returns the M pipeline register to the values set by the constructor
 */
-void M:: dump()
+void M::reset()
 {
-   dumpField("M: stat: ", 1, stat->getOutput(), false);
-   dumpField(" icode: ", 1, icode->getOutput(), false);
-   dumpField(" Cnd: ", 1, Cnd->getOutput(), false);
-   dumpField(" valE: ", 16, valE->getOutput(), false);
-   dumpField(" valA: ", 16, valA->getOutput(), false);
-   dumpField(" dstE: ", 1, dstE->getOutput(), false);
-   dumpField(" dstM: ", 1, dstM->getOutput(), true);
+   stat->bubble(SAOK);
+   icode->bubble(INOP);
+   Cnd->bubble();
+   valE->bubble();
+   valA->bubble();
+   dstE->bubble(RNONE);
+   dstM->bubble(RNONE);
+   pc->bubble(NOPC);
 }
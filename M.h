@@ -9,8 +9,10 @@ class M : public PipeReg
       PipeRegField * valA;
       PipeRegField * dstE;
       PipeRegField * dstM;
+      PipeRegField * pc;    //address of the instruction; not dumped
    public:
       M();
+      ~M();
       PipeRegField * getstat();
       PipeRegField * geticode();
       PipeRegField * getCnd();
@@ -18,5 +20,7 @@ class M : public PipeReg
       PipeRegField * getvalA();
       PipeRegField * getdstE();
       PipeRegField * getdstM();
-      void dump();
+      PipeRegField * getpc();
+      void dump(std::ostream & out);
+      void reset();
 };
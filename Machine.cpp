@@ -0,0 +1,241 @@
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <cstdint>
+#include "Memory.h"
+#include "RegisterFile.h"
+#include "ConditionCodes.h"
+#include "Loader.h"
+#include "PipeRegField.h"
+#include "PipeReg.h"
+#include "F.h"
+#include "D.h"
+#include "E.h"
+#include "M.h"
+#include "W.h"
+#include "Stage.h"
+#include "InstrTable.h"
+#include "FetchStage.h"
+#include "Simulate.h"
+#include "Machine.h"
+#include "Profiler.h"
+#include "SymbolTable.h"
+
+/*
+ * Machine constructor
+ *
+ * creates the pipeline; the machine starts out reset
+ */
+Machine::Machine()
+{
+   simulate = new Simulate();
+   cycle = 0;
+   halted = false;
+}
+
+/*
+ * Machine destructor
+ *
+ * frees the pipeline
+ */
+Machine::~Machine()
+{
+   delete simulate;
+}
+
+/*
+ * reset
+ * clears the memory, register file, condition codes and labels and empties
+ * the pipeline so that the next cycle fetches address 0; only the
+ * memory lines and registers written since the last reset are
+ * touched and every object is reused, so a batch of short programs
+ * can be run back to back without allocating
+ */
+void Machine::reset()
+{
+   Memory::getInstance()->reset();
+   RegisterFile::getInstance()->reset();
+   ConditionCodes::getInstance()->reset();
+   SymbolTable::getInstance()->clear();
+   simulate->reset(0);
+   cycle = 0;
+   halted = false;
+}
+
+/*
+ * loadFile
+ * loads the .yo file named fileName into memory
+ *
+ * @return true if the whole file was loaded
+ */
+bool Machine::loadFile(const char * fileName)
+{
+   Loader load(fileName);
+   return load.isLoaded();
+}
+
+/*
+ * loadBuffer
+ * loads size bytes of .yo formatted text into memory
+ *
+ * @return true if every line was loaded
+ */
+bool Machine::loadBuffer(const char * buffer, uint64_t size)
+{
+   std::istringstream inf(std::string(buffer, size));
+   Loader load(inf);
+   return load.isLoaded();
+}
+
+/*
+ * step
+ * simulates up to cycles clock cycles, stopping early if a halt
+ * reaches the writeback stage
+ *
+ * @return number of cycles simulated
+ */
+uint64_t Machine::step(uint64_t cycles)
+{
+   uint64_t count = 0;
+   while (!halted && count < cycles)
+   {
+      halted = simulate->doClockLow();
+      simulate->doClockHigh();
+      count++;
+   }
+   cycle += count;
+   return count;
+}
+
+/*
+ * runUntil
+ * simulates cycles until the next cycle would fetch the instruction
+ * at pc, the machine halts or maxCycles cycles have been simulated
+ *
+ * @return number of cycles simulated
+ */
+uint64_t Machine::runUntil(uint64_t pc, uint64_t maxCycles)
+{
+   uint64_t count = 0;
+   while (!halted && count < maxCycles && getFetchPC() != pc)
+      count += step(1);
+   return count;
+}
+
+/*
+ * runUntilHalt
+ * simulates cycles until the machine halts or maxCycles cycles have
+ * been simulated
+ *
+ * @return number of cycles simulated
+ */
+uint64_t Machine::runUntilHalt(uint64_t maxCycles)
+{
+   return step(maxCycles);
+}
+
+/*
+ * isHalted
+ * @return true if a halt has reached the writeback stage
+ */
+bool Machine::isHalted()
+{
+   return halted;
+}
+
+/*
+ * getCycle
+ * @return number of cycles simulated since the machine was reset
+ */
+uint64_t Machine::getCycle()
+{
+   return cycle;
+}
+
+/*
+ * getFetchPC
+ * @return address the fetch stage will use in the next cycle
+ */
+uint64_t Machine::getFetchPC()
+{
+   FetchStage * fetch = (FetchStage *) simulate->getStage(FSTAGE);
+   return fetch->selectPC((F *) simulate->getPipeReg(FREG),
+                          (M *) simulate->getPipeReg(MREG),
+                          (W *) simulate->getPipeReg(WREG));
+}
+
+/*
+ * readRegister, writeRegister, getConditionCode, setConditionCode,
+ * getLong, putLong, getByte, putByte
+ * access the register file, condition codes and memory; error is set
+ * as by the RegisterFile, ConditionCodes and Memory methods
+ */
+uint64_t Machine::readRegister(int32_t regNumber, bool & error)
+{
+   return RegisterFile::getInstance()->readRegister(regNumber, error);
+}
+
+void Machine::writeRegister(uint64_t value, int32_t regNumber, bool & error)
+{
+   RegisterFile::getInstance()->writeRegister(value, regNumber, error);
+}
+
+bool Machine::getConditionCode(int32_t ccNum, bool & error)
+{
+   return ConditionCodes::getInstance()->getConditionCode(ccNum, error);
+}
+
+void Machine::setConditionCode(bool value, int32_t ccNum, bool & error)
+{
+   ConditionCodes::getInstance()->setConditionCode(value, ccNum, error);
+}
+
+uint64_t Machine::getLong(int32_t address, bool & error)
+{
+   return Memory::getInstance()->getLong(address, error);
+}
+
+void Machine::putLong(uint64_t value, int32_t address, bool & error)
+{
+   Memory::getInstance()->putLong(value, address, error);
+}
+
+uint8_t Machine::getByte(int32_t address, bool & error)
+{
+   return Memory::getInstance()->getByte(address, error);
+}
+
+void Machine::putByte(uint8_t value, int32_t address, bool & error)
+{
+   Memory::getInstance()->putByte(value, address, error);
+}
+
+/*
+ * getPipeReg
+ * returns a pipelined register so that its fields can be read with
+ * getOutput and written with setInput followed by normal; cast the
+ * result to F, D, E, M or W to reach the fields
+ *
+ * @param index - FREG, DREG, EREG, MREG or WREG
+ */
+PipeReg * Machine::getPipeReg(int32_t index)
+{
+   return simulate->getPipeReg(index);
+}
+
+/*
+ * dump
+ * outputs the pipelined registers, condition codes, register file
+ * and memory in the format used by Simulate::run for the last cycle
+ * simulated
+ */
+void Machine::dump()
+{
+   if (cycle == 0) std::cout << "\nBefore cycle 0:" << std::endl;
+   else std::cout << "\nAt end of cycle " << std::dec << cycle - 1 << ":"
+                  << std::endl;
+   PROFILE(PROFPIPEREGS, simulate->dumpPipeRegs());
+   PROFILE(PROFCC, ConditionCodes::getInstance()->dump());
+   PROFILE(PROFREGS, RegisterFile::getInstance()->dump());
+   PROFILE(PROFMEMORY, Memory::getInstance()->dump());
+}
@@ -0,0 +1,43 @@
+#include <cstdint>
+#ifndef MACHINE_H
+#define MACHINE_H
+
+class PipeReg;
+class Simulate;
+
+//interface for programs that embed the simulator (libyess): loads a
+//program, advances the PIPE machine a cycle at a time and gives
+//direct access to its state. The memory, register file and
+//condition codes are singletons, so there is one machine per process.
+class Machine
+{
+   private:
+      Simulate * simulate;
+      uint64_t cycle;      //number of cycles simulated since the reset
+      bool halted;         //true once a halt reaches the writeback stage
+   public:
+      Machine();
+      ~Machine();
+      Machine(const Machine &) = delete;
+      Machine & operator=(const Machine &) = delete;
+      void reset();
+      bool loadFile(const char * fileName);
+      bool loadBuffer(const char * buffer, uint64_t size);
+      uint64_t step(uint64_t cycles);
+      uint64_t runUntil(uint64_t pc, uint64_t maxCycles);
+      uint64_t runUntilHalt(uint64_t maxCycles);
+      bool isHalted();
+      uint64_t getCycle();
+      uint64_t getFetchPC();
+      uint64_t readRegister(int32_t regNumber, bool & error);
+      void writeRegister(uint64_t value, int32_t regNumber, bool & error);
+      bool getConditionCode(int32_t ccNum, bool & error);
+      void setConditionCode(bool value, int32_t ccNum, bool & error);
+      uint64_t getLong(int32_t address, bool & error);
+      void putLong(uint64_t value, int32_t address, bool & error);
+      uint8_t getByte(int32_t address, bool & error);
+      void putByte(uint8_t value, int32_t address, bool & error);
+      PipeReg * getPipeReg(int32_t index);
+      void dump();
+};
+#endif
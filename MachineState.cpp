@@ -0,0 +1,38 @@
+#include <cstdint>
+#include "Memory.h"
+#include "RegisterFile.h"
+#include "ConditionCodes.h"
+#include "MachineState.h"
+
+/*
+ * save
+ * copies the Memory, RegisterFile and ConditionCodes into the object
+ */
+void MachineState::save()
+{
+   bool error = false;
+   for (int32_t i = 0; i < MEMSIZE; i++)
+      mem[i] = Memory::getInstance()->getByte(i, error);
+   for (int32_t i = 0; i < REGSIZE; i++)
+      reg[i] = RegisterFile::getInstance()->readRegister(i, error);
+   zf = ConditionCodes::getInstance()->getConditionCode(ZF, error);
+   sf = ConditionCodes::getInstance()->getConditionCode(SF, error);
+   of = ConditionCodes::getInstance()->getConditionCode(OF, error);
+}
+
+/*
+ * restore
+ * sets the Memory, RegisterFile and ConditionCodes to the copy
+ * made by save
+ */
+void MachineState::restore()
+{
+   bool error = false;
+   for (int32_t i = 0; i < MEMSIZE; i++)
+      Memory::getInstance()->putByte(mem[i], i, error);
+   for (int32_t i = 0; i < REGSIZE; i++)
+      RegisterFile::getInstance()->writeRegister(reg[i], i, error);
+   ConditionCodes::getInstance()->setConditionCode(zf, ZF, error);
+   ConditionCodes::getInstance()->setConditionCode(sf, SF, error);
+   ConditionCodes::getInstance()->setConditionCode(of, OF, error);
+}
@@ -0,0 +1,17 @@
+#include <cstdint>
+#ifndef MACHINESTATE_H
+#define MACHINESTATE_H
+
+//copy of the architectural state: memory, register file and
+//condition codes
+class MachineState
+{
+   private:
+      uint8_t mem[MEMSIZE];
+      uint64_t reg[REGSIZE];
+      bool zf, sf, of;
+   public:
+      void save();
+      void restore();
+};
+#endif
@@ -17,7 +17,8 @@ Memory::Memory()
    {
       mem[i] = 0;
    }
-   
+   shared = false;
+   for (int i = 0; i < (NUMLINES + 63) / 64; i++) dirty[i] = 0;
 }
 
 /**
@@ -50,6 +51,8 @@ Memory * Memory::getInstance()
  */
 uint64_t Memory::getLong(int32_t address, bool & imem_error)
 {
+   std::unique_lock<std::mutex> guard(lock, std::defer_lock);
+   if (shared) guard.lock();
    if (address >= 0 && address % 8 == 0 && address + 7 < MEMSIZE)
    {
       imem_error = false;
@@ -101,17 +104,52 @@ uint8_t Memory::getByte(int32_t address, bool & imem_error)
  */
 void Memory::putLong(uint64_t value, int32_t address, bool & imem_error)
 {
+   std::unique_lock<std::mutex> guard(lock, std::defer_lock);
+   if (shared) guard.lock();
    if (address % 8 == 0 && address + 7 < MEMSIZE && address >= 0) {
       imem_error = false;
       for (int i = 0; i < LONGSIZE; i++) {
          mem[address + i] = Tools::getByte(value, i);
       }
+      markDirty(address, LONGSIZE);
+      notify(address, LONGSIZE);
    }
    else {
       imem_error = true;
    }
 }
 
+/**
+ * exchangeLong
+ * atomically replaces the 64-bit word at the indicated address by value
+ * and returns the word it held if the address is aligned and within
+ * range, setting imem_error to false; otherwise sets imem_error to true
+ * and leaves memory unchanged
+ *
+ * @param 64-bit value to be stored in memory (mem array)
+ * @param address of 64-bit word; access must be aligned (address % 8 == 0)
+ * @return imem_error is set to true or false
+ * @return previous value of the word or 0 if the address is invalid
+ */
+uint64_t Memory::exchangeLong(uint64_t value, int32_t address, bool & imem_error)
+{
+   std::unique_lock<std::mutex> guard(lock, std::defer_lock);
+   if (shared) guard.lock();
+   if (address % 8 == 0 && address + 7 < MEMSIZE && address >= 0) {
+      imem_error = false;
+      uint64_t old = 0;
+      for (int i = LONGSIZE - 1; i >= 0; i--) {
+         old = (old << 8) | mem[address + i];
+         mem[address + i] = Tools::getByte(value, i);
+      }
+      markDirty(address, LONGSIZE);
+      notify(address, LONGSIZE);
+      return old;
+   }
+   imem_error = true;
+   return 0;
+}
+
 /**
  * putByte
  * sets the byte (8-bits) in memory at the indicated address to the value
@@ -129,6 +167,8 @@ void Memory::putByte(uint8_t value, int32_t address, bool & imem_error)
    {
       imem_error = false;
       mem[address] = value;
+      markDirty(address, 1);
+      notify(address, 1);
    }
    else 
    {
@@ -136,6 +176,40 @@ void Memory::putByte(uint8_t value, int32_t address, bool & imem_error)
    }
 }
 
+/**
+ * markDirty
+ * records that the lines holding the length bytes starting at address
+ * have been written
+ *
+ * @param address of the first byte written (within range)
+ * @param length - number of bytes written
+ */
+void Memory::markDirty(int32_t address, int32_t length)
+{
+   int32_t last = (address + length - 1) / LINESIZE;
+   for (int32_t line = address / LINESIZE; line <= last; line++)
+      dirty[line / 64] |= (uint64_t) 1 << (line % 64);
+}
+
+/**
+ * reset
+ * sets memory back to all 0s, clearing only the lines written since
+ * the last reset, so a short program is reset in a few steps
+ */
+void Memory::reset()
+{
+   for (int32_t i = 0; i < (NUMLINES + 63) / 64; i++)
+   {
+      for (int32_t bit = 0; dirty[i] != 0; bit++)
+      {
+         if (!((dirty[i] >> bit) & 1)) continue;
+         uint8_t * line = mem + (i * 64 + bit) * LINESIZE;
+         for (int32_t j = 0; j < LINESIZE; j++) line[j] = 0;
+         dirty[i] &= ~((uint64_t) 1 << bit);
+      }
+   }
+}
+
 /**
  * dump
  * Output the contents of memory (mem array), four 64-bit words per line.
@@ -144,38 +218,105 @@ void Memory::putByte(uint8_t value, int32_t address, bool & imem_error)
  * line displayed are identical.
  */
 void Memory::dump()
+{
+   uint64_t words[MEMSIZE / 8];
+   bool mem_error;
+
+   for (int32_t i = 0; i < MEMSIZE; i += 8) words[i / 8] = getLong(i, mem_error);
+   dump(std::cout, words);
+}
+
+/**
+ * dump
+ * Output a copy of memory to out in the format used by dump().
+ *
+ * @param out - stream to write to
+ * @param words - the MEMSIZE / 8 64-bit words of memory, address 0 first
+ */
+void Memory::dump(std::ostream & out, const uint64_t words[MEMSIZE / 8])
 {
    uint64_t prevLine[4] = {0, 0, 0, 0};
    uint64_t currLine[4] = {0, 0, 0, 0};
    int32_t i;
    bool star = false;
-   bool mem_error;
 
    //32 bytes per line (four 8-byte words)
    for (i = 0; i < MEMSIZE; i+=32)
    {
       //get the values for the current line
-      for (int32_t j = 0; j < 4; j++) currLine[j] = getLong(i+j*8, mem_error);
+      for (int32_t j = 0; j < 4; j++) currLine[j] = words[i / 8 + j];
 
       //if they are the same as the values in the previous line then
       //don't display them, but always display the first line
       if (i == 0 || currLine[0] != prevLine[0] || currLine[1] != prevLine[1] 
           || currLine[2] != prevLine[2] || currLine[3] != prevLine[3])
       {
-         std::cout << std::endl << std::setw(3) << std::setfill('0') 
-                   << std::hex << i << ": "; 
+         out << std::endl << std::setw(3) << std::setfill('0') 
+             << std::hex << i << ": "; 
          for (int32_t j = 0; j < 4; j++) 
-             std::cout << std::setw(16) << std::setfill('0') 
-                       << std::hex << currLine[j] << " ";
+             out << std::setw(16) << std::setfill('0') 
+                 << std::hex << currLine[j] << " ";
          star = false;
       } else
       {
          //if this line is exactly like the previous line then
          //just print a * if one hasn't been printed already
-         if (star == false) std::cout << "*";
+         if (star == false) out << "*";
          star = true;
       }
       for (int32_t j = 0; j < 4; j++) prevLine[j] = currLine[j];
    }
-   std::cout << std::endl;
+   out << std::endl;
+}
+
+/**
+ * notify
+ * tells each observer that the length bytes starting at address were
+ * written; with no observers a write costs a single test
+ */
+void Memory::notify(int32_t address, int32_t length)
+{
+   for (uint64_t i = 0; i < observers.size(); i++)
+      observers[i]->memoryWritten(address, length);
+}
+
+/**
+ * addObserver
+ * reports every later write to observer; adding an observer that is
+ * already reported to has no effect
+ */
+void Memory::addObserver(MemoryObserver * observer)
+{
+   for (uint64_t i = 0; i < observers.size(); i++)
+      if (observers[i] == observer) return;
+   observers.push_back(observer);
+}
+
+/**
+ * removeObserver
+ * stops reporting writes to observer
+ */
+void Memory::removeObserver(MemoryObserver * observer)
+{
+   for (uint64_t i = 0; i < observers.size(); i++)
+   {
+      if (observers[i] == observer)
+      {
+         observers.erase(observers.begin() + i);
+         return;
+      }
+   }
+}
+
+/**
+ * setShared
+ * makes the word accesses (getLong, putLong, exchangeLong) mutually
+ * exclusive so that cores simulated on several host threads can share
+ * the memory; fetches read single bytes and are not locked
+ *
+ * @param shared - true if several host threads access the memory
+ */
+void Memory::setShared(bool shared)
+{
+   this->shared = shared;
 }
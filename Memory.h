@@ -1,17 +1,49 @@
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <vector>
+#ifndef MEMORY_H
+#define MEMORY_H
 
 //size of memory
 #define MEMSIZE 0x1000
+//memory is reset a line at a time; a line is dirty once written
+#define LINESIZE 64
+#define NUMLINES (MEMSIZE / LINESIZE)
+
+//an object that is told of every store to the Memory once it has
+//been added with Memory::addObserver (the Trigger, a DirtyWords)
+class MemoryObserver
+{
+   public:
+      virtual ~MemoryObserver() {}
+      virtual void memoryWritten(int32_t address, int32_t length) = 0;
+};
+
 class Memory 
 {
    private:
       static Memory * memInstance;
       Memory();
       uint8_t mem[MEMSIZE];
+      std::vector<MemoryObserver *> observers;   //told of every store
+      bool shared;      //true if cores on several host threads access it
+      std::mutex lock;  //held by a word access while shared is true
+      uint64_t dirty[(NUMLINES + 63) / 64];   //bit per line written since reset
+      void markDirty(int32_t address, int32_t length);
+      void notify(int32_t address, int32_t length);
    public:
       static Memory * getInstance();      
       uint64_t getLong(int32_t address, bool & error);
       uint8_t getByte(int32_t address, bool & error);
       void putLong(uint64_t value, int32_t address, bool & error);
       void putByte(uint8_t value, int32_t address, bool & error);
+      uint64_t exchangeLong(uint64_t value, int32_t address, bool & error);
+      void reset();
       void dump();
+      static void dump(std::ostream & out, const uint64_t words[MEMSIZE / 8]);
+      void addObserver(MemoryObserver * observer);
+      void removeObserver(MemoryObserver * observer);
+      void setShared(bool shared);
 }; 
+#endif
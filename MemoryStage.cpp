@@ -1,3 +1,4 @@
+#include <iostream>
 #include <string>
 #include <cstdint>
 #include "RegisterFile.h"
@@ -9,11 +10,14 @@
 #include "M.h"
 #include "W.h"
 #include "Stage.h"
+#include "InstrTable.h"
 #include "MemoryStage.h"
 #include "Status.h"
 #include "Debug.h"
 #include "Instructions.h"
 #include "Memory.h"
+#include "AccessProfile.h"
+#include "Energy.h"
 
 
 /*
@@ -39,28 +43,51 @@ bool MemoryStage::doClockLow(PipeReg ** pregs, Stage ** stages)
    valA = mreg->getvalA()->getOutput();
    dstE = mreg->getdstE()->getOutput();
    dstM = mreg->getdstM()->getOutput();
+   const InstrProps & props = InstrTable::lookup(icode, FNONE);
    
-   uint64_t mem_address = addr(mreg);
-   bool read = mem_read(mreg);
-   bool write = mem_write(mreg);
+   uint64_t mem_address = addr(props, valE, valA);
+   bool read = mem_read(props);
+   bool write = mem_write(props);
 
-   bool error;
-   if (read)
+   bool error = false;
+   if (read && write)
+   {
+      valM = Memory::getInstance()->exchangeLong(valA, mem_address, error);
+      m_valM = valM;
+      TRACE(TRACEMEMORY, std::cout << "memory: exchange " << std::hex
+            << mem_address << " value " << valA << " old " << valM
+            << std::endl);
+   }
+   else if (read)
    {
       valM = Memory::getInstance()->getLong(mem_address, error);
       m_valM = valM;
+      TRACE(TRACEMEMORY, std::cout << "memory: read " << std::hex
+            << mem_address << " value " << valM << std::endl);
    }
    else if (write)
    {
       Memory::getInstance()->putLong(valA, mem_address, error);
+      TRACE(TRACEMEMORY, std::cout << "memory: write " << std::hex
+            << mem_address << " value " << valA << std::endl);
    }
    else
    {
       valM = 0;
       m_valM = 0;
    }
+   if (AccessProfile::isEnabled() && (read || write) && !error)
+      AccessProfile::getInstance()->data(mreg->getpc()->getOutput(),
+                                         mem_address, read, write);
+   if (Energy::isEnabled())
+   {
+      uint64_t pc = mreg->getpc()->getOutput();
+      if (read) Energy::getInstance()->add(ENMEMREAD, pc);
+      if (write) Energy::getInstance()->add(ENMEMWRITE, pc);
+   }
 
    setWInput(wreg, stat, icode, valE, valM, dstE, dstM);
+   wreg->getpc()->setInput(mreg->getpc()->getOutput());
    return false;
 }
 
@@ -70,36 +97,20 @@ uint64_t MemoryStage::getvalM()
 }
 
 
-uint64_t MemoryStage::addr(M *mreg) 
+uint64_t MemoryStage::addr(const InstrProps & props, uint64_t M_valE, uint64_t M_valA) 
 {
-   uint64_t icode = mreg->geticode()->getOutput();
-   uint64_t valE = mreg->getvalE()->getOutput();
-   uint64_t valA = mreg->getvalA()->getOutput();
-
-   if (icode == IRMMOVQ || icode == IPUSHQ || icode == ICALL || icode == IMRMOVQ) 
-   {
-      return valE;
-   } 
-   else if (icode == IPOPQ || icode == IRET) 
-   {
-      return valA;
-   } 
-   else 
-   {
-      return 0;
-   }
+   uint64_t addrs[NUMMADDRSEL] = {0, M_valE, M_valA};
+   return addrs[props.memAddr];
 }
 
-bool MemoryStage::mem_read(M *mreg) 
+bool MemoryStage::mem_read(const InstrProps & props) 
 {
-   uint64_t icode = mreg->geticode()->getOutput();
-   return (icode == IMRMOVQ || icode == IPOPQ || icode == IRET);
+   return props.memRead;
 }
 
-bool MemoryStage::mem_write(M *mreg) 
+bool MemoryStage::mem_write(const InstrProps & props) 
 {
-   uint64_t icode = mreg->geticode()->getOutput();
-   return (icode == IRMMOVQ || icode == IPUSHQ || icode == ICALL);
+   return props.memWrite;
 }
 
 
@@ -119,6 +130,7 @@ void MemoryStage::doClockHigh(PipeReg ** pregs)
    wreg->getvalM()->normal();
    wreg->getdstE()->normal();
    wreg->getdstM()->normal();
+   wreg->getpc()->normal();
 }
 
 void MemoryStage::setWInput(W * wreg, uint64_t stat, uint64_t icode, uint64_t valE, 
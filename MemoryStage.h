@@ -6,9 +6,9 @@ class MemoryStage: public Stage
       uint64_t m_valM;
       void setWInput(W * wreg, uint64_t stat, uint64_t icode, uint64_t valE, 
          uint64_t valM, uint64_t dstE, uint64_t dstM);
-         uint64_t addr(M *mreg);
-      bool mem_read(M *mreg);
-      bool mem_write(M *mreg);
+      uint64_t addr(const InstrProps & props, uint64_t M_valE, uint64_t M_valA);
+      bool mem_read(const InstrProps & props);
+      bool mem_write(const InstrProps & props);
 
 
    public:
@@ -0,0 +1,195 @@
+#include <iostream>
+#include <iomanip>
+#include <cstdint>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include "Memory.h"
+#include "RegisterFile.h"
+#include "ConditionCodes.h"
+#include "Status.h"
+#include "PipeRegField.h"
+#include "PipeReg.h"
+#include "W.h"
+#include "Stage.h"
+#include "Simulate.h"
+#include "Forwarding.h"
+#include "Multicore.h"
+
+/*
+ * Multicore constructor
+ * core 0 uses the RegisterFile, ConditionCodes and Forwarding objects
+ * of the calling thread, so a one core run is the usual simulation;
+ * the other cores get new ones
+ *
+ * @param numCores - number of cores (1 to MAXCORES)
+ * @param threads - number of host threads (1 to numCores)
+ * @param quantum - cycles between the barriers of the host threads
+ */
+Multicore::Multicore(uint64_t numCores, uint64_t threads, uint64_t quantum)
+{
+   this->threads = threads;
+   this->quantum = quantum;
+   for (uint64_t i = 0; i < numCores; i++)
+   {
+      Core core;
+      core.rf = i == 0 ? RegisterFile::getInstance() : RegisterFile::create();
+      core.cc = i == 0 ? ConditionCodes::getInstance() : ConditionCodes::create();
+      core.fwd = i == 0 ? Forwarding::getInstance() : Forwarding::create();
+      bool error = false;
+      core.rf->writeRegister(i, RDI, error);
+      select(core);
+      core.pipeline = new Simulate();
+      core.halted = false;
+      core.stat = SAOK;
+      core.cycles = 0;
+      cores.push_back(core);
+   }
+   select(cores[0]);
+   halted = 0;
+   waiting = 0;
+   generation = 0;
+   done = false;
+}
+
+/*
+ * run
+ * simulates the cores until every one has executed a halt or an
+ * instruction with an error status has reached its W register
+ */
+void Multicore::run()
+{
+   Memory::getInstance()->setShared(threads > 1);
+   std::vector<std::thread> helpers;
+   for (uint64_t t = 1; t < threads; t++)
+      helpers.push_back(std::thread(&Multicore::simulate, this, t));
+   simulate(0);
+   for (uint64_t t = 0; t < helpers.size(); t++) helpers[t].join();
+   Memory::getInstance()->setShared(false);
+   select(cores[0]);
+}
+
+/*
+ * simulate
+ * body of host thread number thread: runs the cores thread,
+ * thread + threads, ... for quantum cycles at a time, waiting at the
+ * barrier after each quantum until every core has stopped
+ */
+void Multicore::simulate(uint64_t thread)
+{
+   do
+   {
+      for (uint64_t cycle = 0; cycle < quantum; cycle++)
+      {
+         for (uint64_t i = thread; i < cores.size(); i += threads)
+         {
+            Core & core = cores[i];
+            if (core.halted) continue;
+            select(core);
+            W * wreg = (W *) core.pipeline->getPipeReg(WREG);
+            uint64_t stat = wreg->getstat()->getOutput();
+            bool stop = core.pipeline->doClockLow();
+            core.pipeline->doClockHigh();
+            core.cycles++;
+            if (stop || stat != SAOK)
+            {
+               core.stat = stop ? SHLT : stat;
+               core.halted = true;
+               halted++;
+            }
+         }
+      }
+   } while (!barrier());
+}
+
+/*
+ * barrier
+ * waits until every host thread has finished its quantum
+ *
+ * @return true if every core has stopped
+ */
+bool Multicore::barrier()
+{
+   std::unique_lock<std::mutex> guard(lock);
+   uint64_t current = generation;
+   if (++waiting == threads)
+   {
+      //the last thread to arrive decides for all of them, so no thread
+      //can see a later halt and leave while the others carry on
+      waiting = 0;
+      done = halted == cores.size();
+      generation++;
+      arrived.notify_all();
+   }
+   else
+   {
+      while (current == generation) arrived.wait(guard);
+   }
+   return done;
+}
+
+/*
+ * select
+ * makes the register file, condition codes and forwarding network of
+ * core the instances the stages use on the calling thread
+ */
+void Multicore::select(Core & core)
+{
+   RegisterFile::setInstance(core.rf);
+   ConditionCodes::setInstance(core.cc);
+   Forwarding::setInstance(core.fwd);
+}
+
+/*
+ * getCycles
+ * @return cycles until the last core stopped
+ */
+uint64_t Multicore::getCycles()
+{
+   uint64_t cycles = 0;
+   for (uint64_t i = 0; i < cores.size(); i++)
+      if (cores[i].cycles > cycles) cycles = cores[i].cycles;
+   return cycles;
+}
+
+/*
+ * getInstructions
+ * @return instructions retired by all of the cores
+ */
+uint64_t Multicore::getInstructions()
+{
+   uint64_t instructions = 0;
+   for (uint64_t i = 0; i < cores.size(); i++)
+      instructions += cores[i].pipeline->getRetired();
+   return instructions;
+}
+
+/*
+ * dump
+ * outputs the aggregate IPC, then the status, IPC, condition codes
+ * and registers of each core, then the shared memory
+ */
+void Multicore::dump()
+{
+   std::cout << "\nAt end of multicore run:" << std::endl;
+   std::cout << std::dec << "cores: " << cores.size() << " threads: "
+             << threads << " quantum: " << quantum << " cycles: "
+             << getCycles() << " instructions: " << getInstructions()
+             << " IPC: " << (double) getInstructions() / getCycles()
+             << std::endl;
+   for (uint64_t i = 0; i < cores.size(); i++)
+   {
+      Core & core = cores[i];
+      std::cout << std::dec << "\ncore " << i << ": stat: " << std::hex
+                << core.stat << std::dec << " cycles: " << core.cycles
+                << " instructions: " << core.pipeline->getRetired()
+                << " IPC: " << (double) core.pipeline->getRetired() /
+                   core.cycles << std::endl;
+      core.cc->dump();
+      core.rf->dump();
+   }
+   select(cores[0]);
+   Memory::getInstance()->dump();
+}
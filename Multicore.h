@@ -0,0 +1,58 @@
+#include <cstdint>
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#ifndef MULTICORE_H
+#define MULTICORE_H
+
+class Simulate;
+class RegisterFile;
+class ConditionCodes;
+class Forwarding;
+
+//limits and defaults of a multicore run
+#define MAXCORES 64
+#define COREQUANTUM 1000   //cycles each host thread runs between barriers
+
+//a simulated core: its own pipeline, register file, condition codes
+//and forwarding network
+struct Core
+{
+   Simulate * pipeline;
+   RegisterFile * rf;
+   ConditionCodes * cc;
+   Forwarding * fwd;
+   bool halted;
+   uint64_t stat;       //status of the instruction that stopped the core
+   uint64_t cycles;     //cycles until the core stopped
+};
+
+//runs several PIPE cores, all starting at address 0 with their core
+//number in %rdi, against the one shared Memory. The cores can be
+//simulated on several host threads that meet at a barrier every
+//quantum cycles; with one thread every core advances one cycle at a
+//time in core order, so the run is deterministic.
+class Multicore
+{
+   private:
+      std::vector<Core> cores;
+      uint64_t threads;
+      uint64_t quantum;
+      std::atomic<uint64_t> halted;   //number of cores that stopped
+      std::mutex lock;                //protects the barrier state
+      std::condition_variable arrived;
+      uint64_t waiting;               //threads waiting at the barrier
+      uint64_t generation;            //number of times the barrier opened
+      bool done;                      //all cores stopped at the last barrier
+      void select(Core & core);
+      void simulate(uint64_t thread);
+      bool barrier();
+   public:
+      Multicore(uint64_t numCores, uint64_t threads, uint64_t quantum);
+      void run();
+      uint64_t getCycles();
+      uint64_t getInstructions();
+      void dump();
+};
+#endif
@@ -0,0 +1,291 @@
+#include <iostream>
+#include <iomanip>
+#include <cstdint>
+#include <vector>
+#include "Memory.h"
+#include "RegisterFile.h"
+#include "ConditionCodes.h"
+#include "Instructions.h"
+#include "Status.h"
+#include "Tools.h"
+#include "Executor.h"
+#include "OutOfOrder.h"
+
+/*
+ * The OutOfOrder core executes each instruction when it is fetched,
+ * using the Executor, so the architectural state it leaves is the
+ * state the program computes. Fetch follows the predictions of the pipeline (jXX taken,
+ * ret unknown): a mispredicted jXX or a ret stops fetch until it
+ * executes. Every cycle the core commits the oldest completed entries
+ * of the reorder buffer, issues the oldest entries of the issue queue
+ * whose operands are available, and renames and dispatches fetched
+ * instructions while the reorder buffer, issue queue, load/store queue
+ * and physical registers have room. The condition codes are renamed
+ * like a register. Load and store addresses are known at fetch, so a
+ * load waits only for the youngest older store to the same word.
+ */
+
+/*
+ * OutOfOrder constructor
+ *
+ * @param config - widths and sizes of the core; see valid
+ */
+OutOfOrder::OutOfOrder(const OoOConfig & config)
+{
+   this->config = config;
+   rob.resize(config.robSize);
+   mem = Memory::getInstance();
+   rf = RegisterFile::getInstance();
+   cc = ConditionCodes::getInstance();
+   stat = SAOK;
+   cycles = 0;
+   instructions = 0;
+}
+
+/*
+ * valid
+ * @return true if every width and size is nonzero and there are
+ *         enough physical registers to rename any instruction
+ */
+bool OutOfOrder::valid(const OoOConfig & config)
+{
+   return config.fetchWidth > 0 && config.issueWidth > 0 &&
+          config.commitWidth > 0 && config.robSize > 0 &&
+          config.iqSize > 0 && config.lsqSize > 0 &&
+          config.physRegs >= OOOARCHREGS + OOOMAXDESTS;
+}
+
+/*
+ * run
+ * runs the program in Memory from address 0 until the halt or
+ * faulting instruction commits
+ */
+void OutOfOrder::run()
+{
+   head = tail = 1;
+   for (uint64_t i = 0; i <= OOOCCREG; i++) writer[i] = 0;
+   for (uint64_t i = 0; i < MEMSIZE / LONGSIZE; i++) lastStore[i] = 0;
+   iqCount = lsqCount = 0;
+   freeRegs = config.physRegs - OOOARCHREGS;
+   pendingValid = waiting = finished = false;
+   fetching = true;
+   fetchCycle = 0;
+   stat = SAOK;
+   executor = Executor();
+   cycles = instructions = occupancy = maxOccupancy = mispredicts = 0;
+   for (uint64_t i = 0; i < NUMSTALLS; i++) stalls[i] = 0;
+
+   //the stages are evaluated in reverse order so that an entry moves
+   //through at most one of them per cycle
+   while (!finished)
+   {
+      commit();
+      issue();
+      dispatch();
+      occupancy += tail - head;
+      if (tail - head > maxOccupancy) maxOccupancy = tail - head;
+      cycles++;
+   }
+}
+
+/*
+ * entry
+ * @return the reorder buffer entry of the instruction numbered seq
+ */
+OoOEntry & OutOfOrder::entry(uint64_t seq)
+{
+   return rob[seq % config.robSize];
+}
+
+/*
+ * ready
+ * @return true if the result of the instruction numbered seq can be
+ *         used in the current cycle
+ */
+bool OutOfOrder::ready(uint64_t seq)
+{
+   return seq < head || (entry(seq).issued && entry(seq).doneCycle <= cycles);
+}
+
+/*
+ * commit
+ * retires up to commitWidth completed entries from the head of the
+ * reorder buffer, releasing their queue entries and the physical
+ * registers that held the values they replaced
+ */
+void OutOfOrder::commit()
+{
+   for (uint64_t n = 0; n < config.commitWidth && head != tail; n++)
+   {
+      OoOEntry & e = entry(head);
+      if (!e.issued || e.doneCycle > cycles) return;
+      freeRegs += e.numDests;
+      if (e.load || e.store) lsqCount--;
+      if (e.stat == SAOK || e.stat == SHLT) instructions++;
+      head++;
+      if (e.stat != SAOK)
+      {
+         stat = e.stat;
+         finished = true;
+         return;
+      }
+   }
+}
+
+/*
+ * issue
+ * sends up to issueWidth entries whose operands are available to the
+ * functional units, oldest first
+ */
+void OutOfOrder::issue()
+{
+   uint64_t issued = 0;
+   for (uint64_t seq = head; seq < tail && issued < config.issueWidth; seq++)
+   {
+      OoOEntry & e = entry(seq);
+      if (e.issued) continue;
+      bool operands = true;
+      for (uint64_t i = 0; i < e.numSrcs; i++) operands &= ready(e.src[i]);
+      if (!operands) continue;
+
+      e.issued = true;
+      e.doneCycle = cycles + e.latency;
+      iqCount--;
+      issued++;
+      if (e.redirect)
+      {
+         waiting = false;
+         fetchCycle = e.doneCycle + OOOREDIRECT;
+      }
+   }
+}
+
+/*
+ * dispatch
+ * fetches, renames and inserts up to fetchWidth instructions into the
+ * reorder buffer, issue queue and load/store queue, counting the
+ * reason when fewer are dispatched
+ */
+void OutOfOrder::dispatch()
+{
+   for (uint64_t n = 0; n < config.fetchWidth && fetching; n++)
+   {
+      uint64_t reason = NUMSTALLS;
+      if (waiting || cycles < fetchCycle) reason = STALLREDIRECT;
+      else if (tail - head == config.robSize) reason = STALLROB;
+      else if (iqCount == config.iqSize) reason = STALLIQ;
+      else
+      {
+         if (!pendingValid) execute(pending);
+         pendingValid = true;
+         if ((pending.load || pending.store) && lsqCount == config.lsqSize)
+            reason = STALLLSQ;
+         else if (pending.numDests > freeRegs)
+            reason = STALLREGS;
+      }
+      if (reason != NUMSTALLS)
+      {
+         stalls[reason]++;
+         return;
+      }
+
+      //rename: the operands come from the youngest older producers
+      OoOEntry & e = entry(tail);
+      e = pending;
+      pendingValid = false;
+      e.numSrcs = 0;
+      for (uint64_t i = 0; i < e.numRegs; i++)
+         e.src[e.numSrcs++] = writer[e.reg[i]];
+      if (e.load) e.src[e.numSrcs++] = lastStore[e.word];
+      for (uint64_t i = 0; i < e.numDests; i++) writer[e.dest[i]] = tail;
+      if (e.store) lastStore[e.word] = tail;
+      freeRegs -= e.numDests;
+      if (e.load || e.store) lsqCount++;
+      iqCount++;
+      tail++;
+
+      if (e.stat != SAOK) fetching = false;
+      if (e.redirect) waiting = true;
+      if (e.taken || e.redirect) return;
+   }
+}
+
+/*
+ * execute
+ * executes the instruction at pc with the Executor and describes it
+ * in e
+ *
+ * @param e - set to the registers, memory word and latency of the
+ *            instruction and to its status
+ */
+void OutOfOrder::execute(OoOEntry & e)
+{
+   InstrRecord r;
+   executor.step(r);
+   e.stat = r.stat;
+   e.numRegs = r.numRegs;
+   for (uint64_t i = 0; i < r.numRegs; i++) e.reg[i] = r.reg[i];
+   e.numDests = r.numDests;
+   for (uint64_t i = 0; i < r.numDests; i++) e.dest[i] = r.dest[i];
+   e.numSrcs = 0;
+   e.word = r.addr / LONGSIZE;
+   e.load = r.load;
+   e.store = r.store;
+   e.latency = r.load ? OOOLOADLATENCY : OOOALULATENCY;
+   e.doneCycle = 0;
+   e.issued = false;
+   e.taken = r.taken;
+   e.redirect = r.redirect;
+   if (r.redirect && r.icode == IJXX) mispredicts++;
+}
+
+/*
+ * getStat
+ * @return status of the last committed instruction
+ */
+uint64_t OutOfOrder::getStat()
+{
+   return stat;
+}
+
+/*
+ * getCycles
+ * @return number of cycles of the last run
+ */
+uint64_t OutOfOrder::getCycles()
+{
+   return cycles;
+}
+
+/*
+ * getInstructions
+ * @return number of instructions committed by the last run
+ */
+uint64_t OutOfOrder::getInstructions()
+{
+   return instructions;
+}
+
+/*
+ * dump
+ * outputs the statistics of the run and the architectural state
+ */
+void OutOfOrder::dump()
+{
+   std::cout << "\nAt end of out-of-order run:" << std::endl;
+   std::cout << "stat: " << std::hex << stat << " pc: "
+             << std::setw(3) << std::setfill('0') << executor.getPC()
+             << std::dec << " instructions: " << instructions
+             << " cycles: " << cycles << " IPC: "
+             << (double) instructions / cycles << std::endl;
+   std::cout << "ROB occupancy: average " << (double) occupancy / cycles
+             << " maximum " << maxOccupancy << " mispredicted jXX: "
+             << mispredicts << std::endl;
+   std::cout << "dispatch stall cycles: rob " << stalls[STALLROB]
+             << " iq " << stalls[STALLIQ] << " lsq " << stalls[STALLLSQ]
+             << " regs " << stalls[STALLREGS] << " redirect "
+             << stalls[STALLREDIRECT] << std::endl;
+   cc->dump();
+   rf->dump();
+   mem->dump();
+}
@@ -0,0 +1,117 @@
+#include <cstdint>
+#include <vector>
+#include "Tools.h"
+#include "Executor.h"
+#ifndef OUTOFORDER_H
+#define OUTOFORDER_H
+
+//default configuration of the out-of-order core
+#define OOOFETCHWIDTH 4     //instructions fetched and renamed per cycle
+#define OOOISSUEWIDTH 4     //instructions issued to the ALUs per cycle
+#define OOOCOMMITWIDTH 4    //instructions committed per cycle
+#define OOOROBSIZE 64       //reorder buffer entries
+#define OOOIQSIZE 32        //issue queue entries
+#define OOOLSQSIZE 16       //load/store queue entries
+#define OOOPHYSREGS 80      //physical registers, including the committed ones
+
+//renamed architectural registers: the register file plus the
+//condition codes, and the most any instruction writes
+#define OOOARCHREGS (REGSIZE + 1)
+#define OOOCCREG EXECCCREG
+#define OOOMAXDESTS 2
+
+//latencies in cycles
+#define OOOALULATENCY 1
+#define OOOLOADLATENCY 2
+#define OOOREDIRECT 2       //from a resolved misprediction to the next fetch
+
+//reasons for dispatching fewer than fetchWidth instructions in a cycle
+#define STALLROB 0          //reorder buffer full
+#define STALLIQ 1           //issue queue full
+#define STALLLSQ 2          //load/store queue full
+#define STALLREGS 3         //no free physical registers
+#define STALLREDIRECT 4     //waiting for a mispredicted jXX or a ret
+#define NUMSTALLS 5
+
+//sizes of the out-of-order core
+struct OoOConfig
+{
+   uint64_t fetchWidth;
+   uint64_t issueWidth;
+   uint64_t commitWidth;
+   uint64_t robSize;
+   uint64_t iqSize;
+   uint64_t lsqSize;
+   uint64_t physRegs;
+};
+
+//an instruction in the reorder buffer
+struct OoOEntry
+{
+   uint64_t reg[EXECMAXREADS];    //architectural registers read (and OOOCCREG)
+   uint64_t numRegs;
+   uint64_t dest[EXECMAXWRITES];  //architectural registers written
+   uint64_t numDests;
+   uint64_t word;       //address / LONGSIZE of a load or store
+   bool load;
+   bool store;
+   uint64_t src[5];     //sequence numbers of the producers of the operands
+   uint64_t numSrcs;
+   uint64_t latency;
+   uint64_t doneCycle;  //cycle in which the result is available
+   uint64_t stat;       //status of the instruction (SAOK, SHLT, ...)
+   bool issued;
+   bool redirect;       //fetch waits for this instruction to execute
+   bool taken;          //ends the fetch group (jmp, call, taken jXX)
+};
+
+//timing model of an out-of-order core with register renaming, an
+//issue queue, a reorder buffer and a load/store queue. The program
+//is executed in order at fetch with the semantics of the pipeline,
+//so the core retires the same architectural state; the model decides
+//in which cycle each instruction issues and commits.
+class OutOfOrder
+{
+   private:
+      OoOConfig config;
+      Memory * mem;
+      RegisterFile * rf;
+      ConditionCodes * cc;
+      Executor executor;
+      std::vector<OoOEntry> rob;
+      uint64_t head;                    //sequence number of the oldest entry
+      uint64_t tail;                    //sequence number of the next entry
+      uint64_t writer[OOOCCREG + 1];    //youngest producer of each register
+      uint64_t lastStore[MEMSIZE / LONGSIZE];
+      uint64_t iqCount;
+      uint64_t lsqCount;
+      uint64_t freeRegs;
+      OoOEntry pending;                 //executed but not yet dispatched
+      bool pendingValid;
+      bool waiting;                     //fetch waits for a redirect entry
+      uint64_t fetchCycle;              //first cycle fetch may resume
+      bool fetching;
+      bool finished;
+      uint64_t stat;
+      uint64_t cycles;
+      uint64_t instructions;
+      uint64_t occupancy;               //sum of the ROB sizes of all cycles
+      uint64_t maxOccupancy;
+      uint64_t mispredicts;
+      uint64_t stalls[NUMSTALLS];
+      OoOEntry & entry(uint64_t seq);
+      bool ready(uint64_t seq);
+      void commit();
+      void issue();
+      void dispatch();
+      void execute(OoOEntry & e);
+   public:
+      OutOfOrder(const OoOConfig & config);
+      static bool valid(const OoOConfig & config);
+      void run();
+      uint64_t getStat();
+      uint64_t getCycles();
+      uint64_t getInstructions();
+      void dump();
+};
+#endif
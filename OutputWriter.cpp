@@ -0,0 +1,132 @@
+#include <iostream>
+#include <sstream>
+#include <cstdint>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include "Memory.h"
+#include "RegisterFile.h"
+#include "Tools.h"
+#include "PipeReg.h"
+#include "Snapshots.h"
+#include "OutputWriter.h"
+
+/*
+ * OutputWriter constructor
+ * creates the ring and starts the writer thread
+ *
+ * @param machine - machine whose state put copies
+ */
+OutputWriter::OutputWriter(Machine * machine)
+{
+   this->machine = machine;
+   ring = new Snapshot[WRITERSLOTS];
+   head = 0;
+   tail = 0;
+   finished = false;
+   snapshots = new Snapshots(machine);
+   writer = std::thread(&OutputWriter::write, this);
+}
+
+/*
+ * OutputWriter destructor
+ * frees the ring and the snapshot copier; finish has to have been
+ * called
+ */
+OutputWriter::~OutputWriter()
+{
+   delete snapshots;
+   delete [] ring;
+}
+
+/*
+ * put
+ * copies the state of the machine at the end of the last cycle it
+ * simulated into the ring, first sleeping until there is a free slot
+ * if the writer has fallen WRITERSLOTS snapshots behind
+ */
+void OutputWriter::put()
+{
+   uint64_t next;
+   {
+      std::unique_lock<std::mutex> guard(lock);
+      space.wait(guard, [this] { return head - tail < WRITERSLOTS; });
+      next = head;
+   }
+
+   //the writer does not read the slot until head moves past it
+   snapshots->take(ring[next % WRITERSLOTS]);
+   bool wake;
+   {
+      std::lock_guard<std::mutex> guard(lock);
+      head = next + 1;
+      //a sleeping writer saw an empty ring, so the count passes half
+      //before it can have work; waking it then and not on every
+      //snapshot keeps the threads from switching each cycle
+      wake = head - tail == WRITERSLOTS / 2;
+   }
+   if (wake) added.notify_one();
+}
+
+/*
+ * finish
+ * waits until every snapshot has been written
+ */
+void OutputWriter::finish()
+{
+   {
+      std::lock_guard<std::mutex> guard(lock);
+      finished = true;
+   }
+   added.notify_one();
+   writer.join();
+   std::cout.flush();
+}
+
+/*
+ * write
+ * body of the writer thread: formats the snapshots in the order they
+ * were added, sleeping while there are none, and writes the output
+ * whenever WRITERBATCH bytes have been collected and once more after
+ * finish is called
+ */
+void OutputWriter::write()
+{
+   std::ostringstream batch;
+   uint64_t next = 0;
+   while (true)
+   {
+      uint64_t last;
+      {
+         std::unique_lock<std::mutex> guard(lock);
+         added.wait(guard, [this, next] { return head != next || finished; });
+         last = head;
+      }
+      if (next == last)
+      {
+         //finished and every snapshot has been formatted
+         std::string text = batch.str();
+         std::cout.write(text.data(), text.length());
+         return;
+      }
+      for (; next < last; next++)
+      {
+         snapshots->format(ring[next % WRITERSLOTS], batch);
+         bool wake;
+         {
+            std::lock_guard<std::mutex> guard(lock);
+            tail = next + 1;
+            //likewise put sleeps on a full ring and is woken once half
+            //of it is free
+            wake = head - tail == WRITERSLOTS / 2;
+         }
+         if (wake) space.notify_one();
+         if (batch.tellp() >= WRITERBATCH)
+         {
+            std::string text = batch.str();
+            std::cout.write(text.data(), text.length());
+            batch.str("");
+         }
+      }
+   }
+}
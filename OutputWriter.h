@@ -0,0 +1,47 @@
+#include <cstdint>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <ostream>
+#ifndef OUTPUTWRITER_H
+#define OUTPUTWRITER_H
+
+//snapshots that can wait to be written; bounds the memory used when
+//the writer falls behind the simulation
+#define WRITERSLOTS 64
+//bytes of formatted output collected before they are written
+#define WRITERBATCH 0x10000
+
+class Machine;
+class Snapshots;
+struct Snapshot;
+
+//writes the state dumps of a run on a background thread. The
+//simulation thread copies the state at the end of each cycle into a
+//ring of snapshots and the writer thread formats them as Machine::dump
+//does, writing to std::cout in WRITERBATCH sized batches. The ring has
+//a single producer and a single consumer that only share the head and
+//tail counts; the producer sleeps while the ring is full and the
+//writer while it is empty, each woken by the other once the ring is
+//half full.
+class OutputWriter
+{
+   private:
+      Machine * machine;
+      Snapshot * ring;
+      std::mutex lock;                //guards head, tail and finished
+      std::condition_variable space;  //signaled when tail moves
+      std::condition_variable added;  //signaled when head moves or on finish
+      uint64_t head;                  //snapshots added by put
+      uint64_t tail;                  //snapshots written
+      bool finished;                  //finish was called
+      Snapshots * snapshots;          //copies and formats the state
+      std::thread writer;
+      void write();
+   public:
+      OutputWriter(Machine * machine);
+      ~OutputWriter();
+      void put();
+      void finish();
+};
+#endif
@@ -0,0 +1,436 @@
+#include <iostream>
+#include <iomanip>
+#include <cmath>
+#include <cstdint>
+#include <map>
+#include <vector>
+#include <algorithm>
+#include "Memory.h"
+#include "RegisterFile.h"
+#include "ConditionCodes.h"
+#include "Instructions.h"
+#include "Status.h"
+#include "PipeRegField.h"
+#include "PipeReg.h"
+#include "W.h"
+#include "Stage.h"
+#include "Simulate.h"
+#include "MachineState.h"
+#include "Executor.h"
+#include "PhaseProfile.h"
+
+/*
+ * The run is made in two passes of the Executor. The first divides
+ * the instructions into intervals and adds the instructions of each
+ * basic block (a run of instructions ending with a jXX, call, ret or
+ * halt) executed in an interval to its vector, which is projected
+ * down to PHASEDIMS dimensions as it is built and divided by the
+ * length of the interval. The vectors are clustered by k-means for 1
+ * to maxPhases phases and the number of phases is chosen by the
+ * Bayesian information criterion. The second pass starts the pipeline
+ * at the first instruction of the representative interval of each
+ * phase and measures its CPI once the pipeline has filled; the state
+ * is then set to the end of the interval and the Executor goes on, and
+ * the final state is the one the first pass left.
+ */
+
+/*
+ * PhaseProfile constructor
+ *
+ * @param interval - instructions per interval
+ * @param maxPhases - most phases the intervals are clustered into
+ */
+PhaseProfile::PhaseProfile(uint64_t interval, uint64_t maxPhases)
+{
+   this->interval = interval;
+   this->maxPhases = maxPhases;
+   instructions = 0;
+   detailInstructions = 0;
+}
+
+/*
+ * valid
+ * @return true if interval is at least 1 and maxPhases is 1 to
+ *         PHASEMAXK
+ */
+bool PhaseProfile::valid(uint64_t interval, uint64_t maxPhases)
+{
+   return interval > 0 && maxPhases > 0 && maxPhases <= PHASEMAXK;
+}
+
+/*
+ * run
+ * executes the program in Memory from address 0 until a halt or an
+ * instruction with an error status, finds its phases and measures
+ * the CPI of each
+ */
+void PhaseProfile::run()
+{
+   MachineState initial, final;
+   initial.save();
+   collect();
+   final.save();
+   cluster();
+   initial.restore();
+   measure();
+   final.restore();
+}
+
+/*
+ * addBlock
+ * adds count instructions of the basic block at address to the
+ * projected vector of the current interval. Each block is projected
+ * by PHASEDIMS fixed pseudo-random weights in [-1, 1] made from its
+ * address.
+ */
+void PhaseProfile::addBlock(uint64_t address, uint64_t count, double * vector)
+{
+   std::map<uint64_t, uint32_t>::iterator it = blocks.find(address);
+   uint32_t index;
+   if (it != blocks.end()) index = it->second;
+   else
+   {
+      index = blocks.size();
+      blocks[address] = index;
+      for (uint64_t j = 0; j < PHASEDIMS; j++)
+      {
+         //splitmix64 of the address and dimension
+         uint64_t z = address * PHASEDIMS + j + 0x9e3779b97f4a7c15ULL;
+         z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+         z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+         z ^= z >> 31;
+         projections.push_back((z >> 11) / 4503599627370496.0 - 1.0);
+      }
+   }
+   for (uint64_t j = 0; j < PHASEDIMS; j++)
+      vector[j] += count * projections[index * PHASEDIMS + j];
+}
+
+/*
+ * collect
+ * executes the program, building the projected basic-block vector of
+ * each interval; the last interval may be shorter
+ */
+void PhaseProfile::collect()
+{
+   Executor executor;
+   InstrRecord r;
+   double vector[PHASEDIMS] = {0};
+   uint64_t block = 0;     //address of the current basic block
+   uint64_t run = 0;       //its instructions not yet added
+   uint64_t count = 0;     //instructions of the current interval
+   bool start = true;      //the next instruction starts a block
+
+   do
+   {
+      executor.step(r);
+      if (r.stat != SAOK && r.stat != SHLT) break;
+      if (start) block = r.pc;
+      run++;
+      count++;
+      instructions++;
+      start = r.icode == IJXX || r.icode == ICALL || r.icode == IRET ||
+              r.icode == IHALT;
+      if (start || count == interval)
+      {
+         addBlock(block, run, vector);
+         run = 0;
+      }
+      if (count == interval)
+      {
+         for (uint64_t j = 0; j < PHASEDIMS; j++)
+         {
+            vectors.push_back(vector[j] / count);
+            vector[j] = 0;
+         }
+         lengths.push_back(count);
+         count = 0;
+      }
+   } while (r.stat == SAOK);
+   if (run > 0) addBlock(block, run, vector);
+   if (count > 0)
+   {
+      for (uint64_t j = 0; j < PHASEDIMS; j++) vectors.push_back(vector[j] / count);
+      lengths.push_back(count);
+   }
+}
+
+/*
+ * distance
+ * @return squared distance between two PHASEDIMS vectors
+ */
+static double distance(const double * a, const double * b)
+{
+   double sum = 0;
+   for (uint64_t j = 0; j < PHASEDIMS; j++) sum += (a[j] - b[j]) * (a[j] - b[j]);
+   return sum;
+}
+
+/*
+ * kmeans
+ * clusters the interval vectors into k phases, starting from the
+ * first interval and each next interval farthest from the centres
+ * chosen so far, until no interval changes phase or PHASEPASSES
+ * passes were made
+ *
+ * @param centres - set to the k centres, PHASEDIMS values each
+ * @param assigned - set to the phase of each interval
+ * @return sum of the squared distances of the intervals to their centres
+ */
+double PhaseProfile::kmeans(uint64_t k, std::vector<double> & centres,
+                            std::vector<uint32_t> & assigned)
+{
+   uint64_t count = lengths.size();
+   std::vector<double> nearest(count);
+   centres.assign(vectors.begin(), vectors.begin() + PHASEDIMS);
+   for (uint64_t i = 0; i < count; i++)
+      nearest[i] = distance(&vectors[i * PHASEDIMS], &centres[0]);
+   for (uint64_t c = 1; c < k; c++)
+   {
+      uint64_t farthest = 0;
+      for (uint64_t i = 1; i < count; i++)
+         if (nearest[i] > nearest[farthest]) farthest = i;
+      centres.insert(centres.end(), vectors.begin() + farthest * PHASEDIMS,
+                     vectors.begin() + (farthest + 1) * PHASEDIMS);
+      for (uint64_t i = 0; i < count; i++)
+         nearest[i] = std::min(nearest[i], distance(&vectors[i * PHASEDIMS],
+                                                    &centres[c * PHASEDIMS]));
+   }
+
+   double total = 0;
+   assigned.assign(count, 0);
+   for (uint64_t pass = 0; pass < PHASEPASSES; pass++)
+   {
+      bool changed = false;
+      total = 0;
+      for (uint64_t i = 0; i < count; i++)
+      {
+         uint32_t best = 0;
+         double bestDistance = distance(&vectors[i * PHASEDIMS], &centres[0]);
+         for (uint32_t c = 1; c < k; c++)
+         {
+            double d = distance(&vectors[i * PHASEDIMS], &centres[c * PHASEDIMS]);
+            if (d < bestDistance)
+            {
+               best = c;
+               bestDistance = d;
+            }
+         }
+         changed = changed || assigned[i] != best || pass == 0;
+         assigned[i] = best;
+         total += bestDistance;
+      }
+      if (!changed) break;
+
+      //a phase left without intervals keeps its centre
+      std::vector<double> sums(k * PHASEDIMS, 0);
+      std::vector<uint64_t> sizes(k, 0);
+      for (uint64_t i = 0; i < count; i++)
+      {
+         sizes[assigned[i]]++;
+         for (uint64_t j = 0; j < PHASEDIMS; j++)
+            sums[assigned[i] * PHASEDIMS + j] += vectors[i * PHASEDIMS + j];
+      }
+      for (uint64_t c = 0; c < k; c++)
+         for (uint64_t j = 0; sizes[c] > 0 && j < PHASEDIMS; j++)
+            centres[c * PHASEDIMS + j] = sums[c * PHASEDIMS + j] / sizes[c];
+   }
+   return total;
+}
+
+/*
+ * bic
+ * @return Bayesian information criterion of the clustering (the log
+ *         likelihood of the intervals under spherical Gaussians around
+ *         the centres, less a penalty for the number of parameters);
+ *         higher is better
+ */
+double PhaseProfile::bic(uint64_t k, const std::vector<double> & centres,
+                         const std::vector<uint32_t> & assigned)
+{
+   uint64_t count = lengths.size();
+   std::vector<uint64_t> sizes(k, 0);
+   double sum = 0;
+   for (uint64_t i = 0; i < count; i++)
+   {
+      sizes[assigned[i]]++;
+      sum += distance(&vectors[i * PHASEDIMS], &centres[assigned[i] * PHASEDIMS]);
+   }
+   double variance = count > k ? sum / (PHASEDIMS * (count - k)) : 0;
+   if (variance < 1e-12) variance = 1e-12;
+
+   double likelihood = 0;
+   for (uint64_t c = 0; c < k; c++)
+   {
+      if (sizes[c] == 0) continue;
+      double n = sizes[c];
+      likelihood += n * std::log(n / count) -
+                    n * PHASEDIMS / 2 * std::log(2 * M_PI * variance) -
+                    (n - k) / 2;
+   }
+   double parameters = (k - 1) + k * PHASEDIMS + 1;
+   return likelihood - parameters / 2 * std::log((double) count);
+}
+
+/*
+ * cluster
+ * clusters the intervals into 1 to maxPhases phases, keeps the fewest
+ * phases whose BIC is within PHASEBIC of the range of the BICs from
+ * the best, and picks the interval nearest each centre; a program
+ * that stops in its first instruction has no intervals and no phases
+ */
+void PhaseProfile::cluster()
+{
+   if (lengths.empty()) return;
+   uint64_t most = std::min(maxPhases, (uint64_t) lengths.size());
+   std::vector<std::vector<double> > centres(most + 1);
+   std::vector<std::vector<uint32_t> > assigned(most + 1);
+   std::vector<double> scores(most + 1);
+   double best = -INFINITY, worst = INFINITY;
+   for (uint64_t k = 1; k <= most; k++)
+   {
+      kmeans(k, centres[k], assigned[k]);
+      scores[k] = bic(k, centres[k], assigned[k]);
+      best = std::max(best, scores[k]);
+      worst = std::min(worst, scores[k]);
+   }
+   uint64_t k = 1;
+   while (k < most && scores[k] < worst + PHASEBIC * (best - worst)) k++;
+
+   //number the phases in the order they first appear
+   std::vector<int32_t> number(k, -1);
+   phaseOf.resize(lengths.size());
+   for (uint64_t i = 0; i < lengths.size(); i++)
+   {
+      uint32_t c = assigned[k][i];
+      if (number[c] < 0)
+      {
+         number[c] = phases.size();
+         Phase phase = {0, 0, i, 0};
+         phases.push_back(phase);
+      }
+      Phase & phase = phases[number[c]];
+      phaseOf[i] = number[c];
+      phase.intervals++;
+      phase.instructions += lengths[i];
+      const double * centre = &centres[k][c * PHASEDIMS];
+      if (distance(&vectors[i * PHASEDIMS], centre) <
+          distance(&vectors[phase.representative * PHASEDIMS], centre))
+         phase.representative = i;
+   }
+}
+
+/*
+ * measure
+ * executes the program again and runs the pipeline on the
+ * representative interval of each phase to measure its CPI: the
+ * cycles from the first to the last of the interval's instructions
+ * reaching the W register, over the instructions in between. The
+ * pipeline does not squash, so it also retires instructions the
+ * program does not execute; only the interval's instructions, as the
+ * Executor lists them, are counted.
+ */
+void PhaseProfile::measure()
+{
+   std::map<uint64_t, uint64_t> starts;   //representative to phase
+   for (uint64_t p = 0; p < phases.size(); p++)
+      starts[phases[p].representative] = p;
+
+   Executor executor;
+   InstrRecord r;
+   Simulate detail;
+   W * wreg = (W *) detail.getPipeReg(WREG);
+   MachineState start, end;
+   std::vector<uint64_t> pcs;
+   uint64_t executed = 0;
+   std::map<uint64_t, uint64_t>::iterator it;
+   for (it = starts.begin(); it != starts.end(); it++)
+   {
+      for (; executed < it->first * interval; executed++) executor.step(r);
+
+      uint64_t length = lengths[it->first];
+      start.save();
+      pcs.clear();
+      for (uint64_t i = 0; i < length; i++, executed++)
+      {
+         executor.step(r);
+         pcs.push_back(r.pc);
+      }
+      end.save();
+      start.restore();
+
+      bool stop = false;
+      uint64_t matched = 0, cycle = 0, first = 0, last = 0;
+      detail.reset(pcs[0]);
+      while (!stop && matched < length && cycle < PHASEMAXCPI * length + NUMPIPEREGS)
+      {
+         if (wreg->getpc()->getOutput() == pcs[matched])
+         {
+            if (matched == 0) first = cycle;
+            last = cycle;
+            matched++;
+         }
+         stop = detail.doClockLow();
+         detail.doClockHigh();
+         cycle++;
+      }
+      phases[it->second].cpi = matched > 1 ? (double) (last - first) / (matched - 1) : 1;
+      detailInstructions += detail.getRetired();
+      end.restore();
+   }
+}
+
+/*
+ * getEstimatedCPI
+ * @return CPI of the representative intervals weighted by the
+ *         instructions in their phases
+ */
+double PhaseProfile::getEstimatedCPI()
+{
+   double cpi = 0;
+   for (uint64_t p = 0; p < phases.size(); p++)
+      cpi += phases[p].cpi * phases[p].instructions / instructions;
+   return cpi;
+}
+
+/*
+ * dump
+ * outputs each phase with its weight and representative interval,
+ * the phase of each interval as runs of "phase x intervals", the
+ * estimated CPI and cycles, then the condition codes, register file
+ * and memory left by the program
+ */
+void PhaseProfile::dump()
+{
+   std::cout << std::dec << "\nPhases of " << instructions << " instructions in "
+             << lengths.size() << " intervals of " << interval << " ("
+             << blocks.size() << " basic blocks):" << std::endl;
+   std::cout << "phase intervals  weight representative     CPI" << std::endl;
+   std::cout << std::fixed;
+   for (uint64_t p = 0; p < phases.size(); p++)
+   {
+      std::cout << std::setw(5) << p << " " << std::setw(9) << phases[p].intervals
+                << " " << std::setprecision(1) << std::setw(6)
+                << 100.0 * phases[p].instructions / instructions << "% "
+                << std::setw(14) << phases[p].representative << " "
+                << std::setprecision(3) << std::setw(7) << phases[p].cpi
+                << std::endl;
+   }
+   std::cout << "phase of each interval:";
+   for (uint64_t i = 0; i < phaseOf.size();)
+   {
+      uint64_t end = i;
+      while (end < phaseOf.size() && phaseOf[end] == phaseOf[i]) end++;
+      std::cout << " " << phaseOf[i] << "x" << end - i;
+      i = end;
+   }
+   double cpi = getEstimatedCPI();
+   std::cout << std::endl << "estimated CPI: " << cpi << " estimated cycles: "
+             << (uint64_t) std::llround(cpi * instructions) + NUMPIPEREGS - 1
+             << " detailed instructions: " << detailInstructions << std::endl;
+   std::cout.unsetf(std::ios::floatfield);
+   std::cout << std::setprecision(6);
+   ConditionCodes::getInstance()->dump();
+   RegisterFile::getInstance()->dump();
+   Memory::getInstance()->dump();
+}
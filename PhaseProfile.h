@@ -0,0 +1,65 @@
+#include <cstdint>
+#include <map>
+#include <vector>
+#ifndef PHASEPROFILE_H
+#define PHASEPROFILE_H
+
+//default instructions per interval and most phases looked for
+#define PHASEINTERVAL 1000
+#define PHASEMAX 10
+//limit on the number of phases
+#define PHASEMAXK 32
+//dimensions the basic-block vectors are projected down to
+#define PHASEDIMS 15
+//k-means passes for each number of phases
+#define PHASEPASSES 100
+//most cycles per instruction a representative interval is run for
+#define PHASEMAXCPI 8
+//the fewest phases whose BIC is within this share of the best is chosen
+#define PHASEBIC 0.9
+
+//a phase: intervals whose basic-block vectors are alike
+struct Phase
+{
+   uint64_t intervals;        //intervals in the phase
+   uint64_t instructions;     //instructions in them
+   uint64_t representative;   //interval closest to the centroid
+   double cpi;                //CPI the pipeline measured on it
+};
+
+//divides a run of the program into intervals of a fixed number of
+//instructions and describes each one by its basic-block vector: the
+//instructions executed in each basic block during the interval. The
+//vectors are clustered into phases with k-means and the interval
+//nearest the centre of each phase is simulated by the pipeline, so
+//the CPI of the whole program is estimated from a few intervals
+//weighted by the size of their phases.
+class PhaseProfile
+{
+   private:
+      uint64_t interval;
+      uint64_t maxPhases;
+      std::map<uint64_t, uint32_t> blocks;      //block address to index
+      std::vector<double> projections;          //PHASEDIMS per block
+      std::vector<double> vectors;              //PHASEDIMS per interval
+      std::vector<uint64_t> lengths;            //instructions per interval
+      std::vector<uint32_t> phaseOf;            //phase of each interval
+      std::vector<Phase> phases;
+      uint64_t instructions;
+      uint64_t detailInstructions;
+      void addBlock(uint64_t address, uint64_t count, double * vector);
+      void collect();
+      double kmeans(uint64_t k, std::vector<double> & centres,
+                    std::vector<uint32_t> & assigned);
+      double bic(uint64_t k, const std::vector<double> & centres,
+                 const std::vector<uint32_t> & assigned);
+      void cluster();
+      void measure();
+   public:
+      PhaseProfile(uint64_t interval, uint64_t maxPhases);
+      static bool valid(uint64_t interval, uint64_t maxPhases);
+      void run();
+      double getEstimatedCPI();
+      void dump();
+};
+#endif
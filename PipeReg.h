@@ -9,17 +9,28 @@
 //number of PipeRegisters
 #define NUMPIPEREGS 5
 
+//number of pipeline register fields (F 1, D 7, E 10, M 7, W 6)
+#define NUMFIELDS 31
+
+//pc field of a bubble; never the address of an instruction
+#define NOPC 0x7fffffff
+
 //base class for the F, D, E, M, W pipeline registers
 class PipeReg
 {
    public:
+      virtual ~PipeReg() {}
       //dump method is implemented in the classes that descend
-      //from PipeReg
+      //from PipeReg; it writes the register to out
       //
       //dump is abstract
       //virtual makes it polymorphic 
-      virtual void dump() = 0;
+      virtual void dump(std::ostream & out) = 0;
+      //reset is implemented in the classes that descend from
+      //PipeReg; it returns every field to its initial value
+      virtual void reset() = 0;
    protected:
-      void dumpField(std::string label, int width, uint64_t value, bool nl);
+      void dumpField(std::ostream & out, std::string label, int width,
+                     uint64_t value, bool nl);
 };
 
@@ -0,0 +1,61 @@
+#include <iostream>
+#include <iomanip>
+#include <cstdint>
+#include "Profiler.h"
+
+bool Profiler::enabled = false;
+uint64_t Profiler::nanos[NUMPROF] = {0};
+uint64_t Profiler::calls[NUMPROF] = {0};
+
+/*
+ * setEnabled
+ * @param enabled - true to time the components from now on
+ */
+void Profiler::setEnabled(bool enabled)
+{
+   Profiler::enabled = enabled;
+}
+
+/*
+ * name
+ * @return name of the component ("F low", ..., "memory dump")
+ */
+const char * Profiler::name(int32_t component)
+{
+   static const char * names[NUMPROF] = {
+      "F low", "D low", "E low", "M low", "W low",
+      "F high", "D high", "E high", "M high", "W high",
+      "pipereg dump", "cc dump", "regfile dump", "memory dump"
+   };
+   return names[component];
+}
+
+/*
+ * dump
+ * outputs the host nanoseconds per simulated cycle spent in each
+ * component that was timed and its share of the total; the number of
+ * cycles is the number of calls of the writeback stage's doClockLow
+ */
+void Profiler::dump()
+{
+   uint64_t cycles = calls[PROFLOW + 4];   //WSTAGE
+   uint64_t total = 0;
+   for (int32_t i = 0; i < NUMPROF; i++) total += nanos[i];
+   if (cycles == 0 || total == 0) return;
+
+   std::cout << std::dec << "\nHost time per simulated cycle (" << cycles
+             << " cycles):" << std::endl;
+   std::cout << std::fixed << std::setprecision(1) << std::setfill(' ');
+   for (int32_t i = 0; i < NUMPROF; i++)
+   {
+      if (calls[i] == 0) continue;
+      std::cout << std::setw(12) << name(i) << ": " << std::setw(9)
+                << (double) nanos[i] / cycles << " ns "
+                << std::setw(5) << 100.0 * nanos[i] / total << "%"
+                << std::endl;
+   }
+   std::cout << std::setw(12) << "total" << ": " << std::setw(9)
+             << (double) total / cycles << " ns" << std::endl;
+   std::cout.unsetf(std::ios::floatfield);
+   std::cout << std::setprecision(6);
+}
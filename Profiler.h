@@ -0,0 +1,69 @@
+#include <cstdint>
+#include <chrono>
+#ifndef PROFILER_H
+#define PROFILER_H
+
+//components of the simulator that are timed; the stages are indexed
+//by FSTAGE, ..., WSTAGE within each group
+#define PROFLOW 0          //Stage::doClockLow of each stage
+#define PROFHIGH 5         //Stage::doClockHigh of each stage
+#define PROFPIPEREGS 10    //dump of the pipeline registers
+#define PROFCC 11          //ConditionCodes dump
+#define PROFREGS 12        //RegisterFile dump
+#define PROFMEMORY 13      //Memory dump
+#define NUMPROF 14
+
+//host time spent in each component of the simulator. Use PROFILE
+//rather than calling these directly: when profiling is disabled a
+//profiled statement costs one test of a flag.
+class Profiler
+{
+   private:
+      static bool enabled;
+      static uint64_t nanos[NUMPROF];
+      static uint64_t calls[NUMPROF];
+   public:
+      static void setEnabled(bool enabled);
+      static bool isEnabled();
+      static uint64_t now();
+      static void add(int32_t component, uint64_t start);
+      static const char * name(int32_t component);
+      static void dump();
+};
+
+/*
+ * isEnabled
+ * @return true if the components are being timed
+ */
+inline bool Profiler::isEnabled()
+{
+   return enabled;
+}
+
+/*
+ * now
+ * @return host time in nanoseconds from the steady clock
+ */
+inline uint64_t Profiler::now()
+{
+   return std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/*
+ * add
+ * charges the time since start to component
+ */
+inline void Profiler::add(int32_t component, uint64_t start)
+{
+   nanos[component] += now() - start;
+   calls[component]++;
+}
+
+//performs a statement, timing it as component if profiling is enabled
+#define PROFILE(component, ...) \
+   do { if (Profiler::isEnabled()) \
+        { uint64_t profileStart = Profiler::now(); __VA_ARGS__; \
+          Profiler::add(component, profileStart); } \
+        else { __VA_ARGS__; } } while (0)
+#endif
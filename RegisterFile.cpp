@@ -2,10 +2,13 @@
 #include <iomanip>
 #include "RegisterFile.h"
 #include "Tools.h"
+#include "Memory.h"
+#include "Trigger.h"
 
 //regInstance will be initialized to the single RegisterFile
-//object that is created
-RegisterFile * RegisterFile::regInstance = NULL;
+//object that is created; a multicore run points each host thread's
+//regInstance at the register file of the core it is simulating
+thread_local RegisterFile * RegisterFile::regInstance = NULL;
 
 /**
  * RegisterFile constructor
@@ -17,7 +20,8 @@ RegisterFile::RegisterFile()
    {
       reg[i] = 0;
    }
-   
+   watched = false;
+   written = 0;
 }
 
 /**
@@ -38,6 +42,29 @@ RegisterFile * RegisterFile::getInstance()
    return regInstance;
 }
 
+/**
+ * create
+ * creates a further RegisterFile, for another simulated core
+ *
+ * @return pointer to the new RegisterFile with every register 0
+ */
+RegisterFile * RegisterFile::create()
+{
+   return new RegisterFile();
+}
+
+/**
+ * setInstance
+ * makes instance the RegisterFile that getInstance returns to the
+ * calling thread
+ *
+ * @param instance - RegisterFile of the core being simulated
+ */
+void RegisterFile::setInstance(RegisterFile * instance)
+{
+   regInstance = instance;
+}
+
 /**
  * readRegister
  * returns a register value from the reg array.
@@ -78,6 +105,8 @@ void RegisterFile::writeRegister(uint64_t value, int32_t regNumber,
    {
       error = false;
       reg[regNumber] = value;
+      written |= 1 << regNumber;
+      if (watched) Trigger::getInstance()->registerWritten(regNumber);
    }
    else
    {
@@ -85,11 +114,37 @@ void RegisterFile::writeRegister(uint64_t value, int32_t regNumber,
    }
 }
 
+/**
+ * reset
+ * sets the registers written since the last reset back to 0
+ */
+void RegisterFile::reset()
+{
+   for (int i = 0; written != 0; i++)
+   {
+      if ((written >> i) & 1) reg[i] = 0;
+      written &= ~(1 << i);
+   }
+}
+
 /**
  * dump
  * output the contents of the reg array
  */
 void RegisterFile::dump()
+{
+   dump(std::cout, reg);
+}
+
+/**
+ * dump
+ * output the contents of a register file to out in the format
+ * used by dump()
+ *
+ * @param out - stream to write to
+ * @param values - the REGSIZE registers, %rax first
+ */
+void RegisterFile::dump(std::ostream & out, const uint64_t values[REGSIZE])
 {
    std::string rnames[15] = {"%rax: ", "%rcx: ", "%rdx: ",  "%rbx: ",
                              "%rsp: ", "%rbp: ", "%rsi: ",  "%rdi: ", 
@@ -98,12 +153,24 @@ void RegisterFile::dump()
    for (int32_t i = 0; i < REGSIZE; i+=4)
    {
       for (int32_t j = 0; j < 3; j++)
-         std::cout << rnames[i + j] << std::hex << std::setw(16) 
-                   << std::setfill('0') << reg[i + j] << ' ';
+         out << rnames[i + j] << std::hex << std::setw(16) 
+             << std::setfill('0') << values[i + j] << ' ';
       if (i + 3 < REGSIZE) 
-         std::cout << rnames[i + 3] << std::hex << std::setw(16) 
-                   << std::setfill('0') << reg[i + 3] << std::endl;
+         out << rnames[i + 3] << std::hex << std::setw(16) 
+             << std::setfill('0') << values[i + 3] << std::endl;
       else
-         std::cout << std::endl;
+         out << std::endl;
    }
 }
+
+/**
+ * setWatched
+ * turns the reporting of writes to the Trigger on or off; when it is
+ * off a write costs a single test of the watched flag
+ *
+ * @param watched - true to report writes
+ */
+void RegisterFile::setWatched(bool watched)
+{
+   this->watched = watched;
+}
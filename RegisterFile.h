@@ -1,3 +1,4 @@
+#include <ostream>
 #define REGSIZE 15  //size of register file
 //Register numbers of Y86 registers
 //When a special register, such as RSP, is
@@ -23,13 +24,20 @@
 class RegisterFile 
 {
    private:
-      static RegisterFile * regInstance;
+      static thread_local RegisterFile * regInstance;
       RegisterFile();
       uint64_t reg[REGSIZE];
+      bool watched;     //true if writes are reported to the Trigger
+      uint32_t written; //bit per register written since the last reset
    public:
       static RegisterFile * getInstance();      
+      static RegisterFile * create();
+      static void setInstance(RegisterFile * instance);
       uint64_t readRegister(int32_t regNumber, bool & error);
       void writeRegister(uint64_t value, int32_t regNumber, 
                         bool & error);
+      void reset();
       void dump();
+      static void dump(std::ostream & out, const uint64_t values[REGSIZE]);
+      void setWatched(bool watched);
 }; 
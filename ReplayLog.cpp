@@ -0,0 +1,383 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "Memory.h"
+#include "RegisterFile.h"
+#include "ConditionCodes.h"
+#include "Tools.h"
+#include "PipeRegField.h"
+#include "PipeReg.h"
+#include "F.h"
+#include "D.h"
+#include "E.h"
+#include "M.h"
+#include "W.h"
+#include "Machine.h"
+#include "ReplayLog.h"
+
+/*
+ * Log file layout (all longs are 8 bytes, little endian):
+ *   "YESSLOG1", interval
+ *   one record per cycle: count, then count (slot, value) pairs, all
+ *   LEB128 varints; the record of every interval-th cycle is a
+ *   keyframe that lists every nonzero slot
+ *   index: file offset of each keyframe record
+ *   trailer: number of cycles, number of keyframes, index offset
+ * Memory words are only compared in the cycles that stored to them:
+ * a DirtyWords observes the Memory while the log is recorded.
+ */
+
+//logInstance will be initialized to the single ReplayLog object
+ReplayLog * ReplayLog::logInstance = NULL;
+
+const int32_t ReplayLog::numFields[NUMPIPEREGS] = {1, 7, 10, 7, 6};
+
+/*
+ * ReplayLog constructor
+ */
+ReplayLog::ReplayLog()
+{
+   for (int32_t i = 0; i < NUMFIELDS; i++) fields[i] = NULL;
+   for (int32_t i = 0; i < NUMSLOTS; i++) slots[i] = 0;
+}
+
+/*
+ * getInstance
+ * if logInstance is NULL then creates a ReplayLog object
+ * and sets logInstance to point to it; returns logInstance
+ *
+ * @return logInstance
+ */
+ReplayLog * ReplayLog::getInstance()
+{
+   if (logInstance == NULL)
+   {
+      logInstance = new ReplayLog();
+   }
+   return logInstance;
+}
+
+/*
+ * bindFields
+ * makes fields point to the pipeline register fields of machine in
+ * the order in which the registers are dumped
+ */
+void ReplayLog::bindFields(Machine & machine)
+{
+   PipeReg * pregs[NUMPIPEREGS];
+   for (int32_t i = 0; i < NUMPIPEREGS; i++) pregs[i] = machine.getPipeReg(i);
+   bindFields(pregs, fields);
+}
+
+/*
+ * bindFields
+ * makes fields point to the NUMFIELDS fields of the pipeline
+ * registers pregs in the order in which the registers are dumped
+ *
+ * @param pregs - the F, D, E, M and W registers, indexed by FREG, ...
+ * @param fields - array of NUMFIELDS pointers that is filled in
+ */
+void ReplayLog::bindFields(PipeReg * pregs[], PipeRegField * fields[])
+{
+   F * freg = (F *) pregs[FREG];
+   D * dreg = (D *) pregs[DREG];
+   E * ereg = (E *) pregs[EREG];
+   M * mreg = (M *) pregs[MREG];
+   W * wreg = (W *) pregs[WREG];
+   PipeRegField * all[NUMFIELDS] = {
+      freg->getpredPC(),
+      dreg->getstat(), dreg->geticode(), dreg->getifun(), dreg->getrA(),
+      dreg->getrB(), dreg->getvalC(), dreg->getvalP(),
+      ereg->getstat(), ereg->geticode(), ereg->getifun(), ereg->getvalC(),
+      ereg->getvalA(), ereg->getvalB(), ereg->getdstE(), ereg->getdstM(),
+      ereg->getsrcA(), ereg->getsrcB(),
+      mreg->getstat(), mreg->geticode(), mreg->getCnd(), mreg->getvalE(),
+      mreg->getvalA(), mreg->getdstE(), mreg->getdstM(),
+      wreg->getstat(), wreg->geticode(), wreg->getvalE(), wreg->getvalM(),
+      wreg->getdstE(), wreg->getdstM()
+   };
+   for (int32_t i = 0; i < NUMFIELDS; i++) fields[i] = all[i];
+}
+
+/*
+ * capture
+ * compares the state of machine with slots and appends a (slot, value)
+ * pair to changes for each slot that differs, updating slots. For a
+ * keyframe every nonzero slot is appended and every memory word is
+ * read; otherwise only the words stored to in the cycle are read.
+ */
+void ReplayLog::capture(Machine & machine, std::vector<uint64_t> & changes,
+                        bool keyframe)
+{
+   uint64_t values[MEMSLOT];
+   bool error = false;
+
+   changes.clear();
+   for (int32_t i = 0; i < NUMFIELDS; i++)
+      values[FIELDSLOT + i] = fields[i]->getOutput();
+   for (int32_t i = 0; i < REGSIZE; i++)
+      values[REGSLOT + i] = machine.readRegister(i, error);
+   values[CCSLOT] = machine.getConditionCode(ZF, error) |
+                    machine.getConditionCode(SF, error) << 1 |
+                    machine.getConditionCode(OF, error) << 2;
+   for (int32_t i = 0; i < MEMSLOT; i++)
+   {
+      if (keyframe ? values[i] != 0 : values[i] != slots[i])
+      {
+         changes.push_back(i);
+         changes.push_back(values[i]);
+      }
+      slots[i] = values[i];
+   }
+
+   if (keyframe)
+   {
+      for (int32_t i = 0; i < MEMWORDS; i++)
+      {
+         slots[MEMSLOT + i] = machine.getLong(i * LONGSIZE, error);
+         if (slots[MEMSLOT + i] == 0) continue;
+         changes.push_back(MEMSLOT + i);
+         changes.push_back(slots[MEMSLOT + i]);
+      }
+   }
+   else
+   {
+      const std::vector<uint64_t> & words = dirty.getWords();
+      for (uint64_t i = 0; i < words.size(); i++)
+      {
+         uint64_t word = words[i];
+         uint64_t value = machine.getLong(word * LONGSIZE, error);
+         if (value == slots[MEMSLOT + word]) continue;
+         changes.push_back(MEMSLOT + word);
+         changes.push_back(value);
+         slots[MEMSLOT + word] = value;
+      }
+   }
+   dirty.clear();
+}
+
+/*
+ * restore
+ * sets the pipeline registers, register file, condition codes and
+ * memory of machine to slots
+ */
+void ReplayLog::restore(Machine & machine)
+{
+   bool error = false;
+   for (int32_t i = 0; i < NUMFIELDS; i++)
+   {
+      fields[i]->setInput(slots[FIELDSLOT + i]);
+      fields[i]->normal();
+   }
+   for (int32_t i = 0; i < REGSIZE; i++)
+      machine.writeRegister(slots[REGSLOT + i], i, error);
+   machine.setConditionCode(slots[CCSLOT] & 1, ZF, error);
+   machine.setConditionCode(slots[CCSLOT] >> 1 & 1, SF, error);
+   machine.setConditionCode(slots[CCSLOT] >> 2 & 1, OF, error);
+   for (int32_t i = 0; i < MEMWORDS; i++)
+      machine.putLong(slots[MEMSLOT + i], i * LONGSIZE, error);
+}
+
+/*
+ * writeVarint
+ * writes value as a LEB128 varint: 7 bits per byte, low bits first,
+ * with the top bit set in every byte but the last
+ */
+void ReplayLog::writeVarint(std::ostream & out, uint64_t value)
+{
+   while (value >= 0x80)
+   {
+      out.put((char) (value | 0x80));
+      value >>= 7;
+   }
+   out.put((char) value);
+}
+
+/*
+ * readVarint
+ * reads a LEB128 varint written by writeVarint
+ *
+ * @return false at the end of the stream or on a malformed varint
+ */
+bool ReplayLog::readVarint(std::istream & in, uint64_t & value)
+{
+   value = 0;
+   for (int32_t shift = 0; shift < 64; shift += 7)
+   {
+      int byte = in.get();
+      if (byte == EOF) return false;
+      value |= (uint64_t) (byte & 0x7f) << shift;
+      if ((byte & 0x80) == 0) return true;
+   }
+   return false;
+}
+
+/*
+ * writeLong
+ * writes value as 8 little endian bytes
+ */
+void ReplayLog::writeLong(std::ostream & out, uint64_t value)
+{
+   for (int32_t i = 0; i < LONGSIZE; i++)
+      out.put((char) Tools::getByte(value, i));
+}
+
+/*
+ * readLong
+ * @return the 8 little endian bytes written by writeLong
+ */
+uint64_t ReplayLog::readLong(std::istream & in)
+{
+   uint8_t bytes[LONGSIZE] = {0};
+   for (int32_t i = 0; i < LONGSIZE; i++) bytes[i] = (uint8_t) in.get();
+   return Tools::buildLong(bytes);
+}
+
+/*
+ * readRecord
+ * reads one cycle's record and applies its changes to slots
+ *
+ * @return false if the record is malformed
+ */
+bool ReplayLog::readRecord(std::istream & in)
+{
+   uint64_t count, slot, value;
+   if (!readVarint(in, count)) return false;
+   for (uint64_t i = 0; i < count; i++)
+   {
+      if (!readVarint(in, slot) || !readVarint(in, value) ||
+          slot >= NUMSLOTS) return false;
+      slots[slot] = value;
+   }
+   return true;
+}
+
+/*
+ * record
+ * simulates machine until it halts, writing the changes made by each
+ * cycle to the file fileName
+ *
+ * @param machine - loaded machine to run
+ * @param fileName - name of the log file to create
+ * @param interval - number of cycles between keyframes
+ * @return false if the log could not be written
+ */
+bool ReplayLog::record(Machine & machine, const char * fileName,
+                       uint64_t interval)
+{
+   std::ofstream out(fileName, std::ios::binary);
+   if (!out.is_open() || interval == 0) return false;
+
+   std::vector<uint64_t> keyframes;
+   std::vector<uint64_t> changes;
+   uint64_t cycle = 0;
+
+   bindFields(machine);
+   out.write("YESSLOG1", LONGSIZE);
+   writeLong(out, interval);
+   Memory::getInstance()->addObserver(&dirty);
+   while (!machine.isHalted())
+   {
+      machine.step(1);
+      bool keyframe = cycle % interval == 0;
+      if (keyframe) keyframes.push_back(out.tellp());
+      capture(machine, changes, keyframe);
+      writeVarint(out, changes.size() / 2);
+      for (uint64_t i = 0; i < changes.size(); i++)
+         writeVarint(out, changes[i]);
+      cycle++;
+   }
+   Memory::getInstance()->removeObserver(&dirty);
+
+   uint64_t indexOffset = out.tellp();
+   for (uint64_t i = 0; i < keyframes.size(); i++) writeLong(out, keyframes[i]);
+   writeLong(out, cycle);
+   writeLong(out, keyframes.size());
+   writeLong(out, indexOffset);
+   return out.good();
+}
+
+/*
+ * replay
+ * rebuilds the state at the end of each cycle from first to last
+ * (counting down if last is less than first) from the log file
+ * fileName and outputs it in the format used by Simulate::run. Each
+ * cycle that does not directly follow the previous one is rebuilt by
+ * reading the keyframe before it and the records in between.
+ *
+ * @param machine - machine whose state is overwritten and dumped
+ * @param fileName - name of a log file written by record
+ * @return false if the file is not a log, its trailer and index do
+ *         not match its length or the cycles are not in it
+ */
+bool ReplayLog::replay(Machine & machine, const char * fileName,
+                       uint64_t first, uint64_t last)
+{
+   std::ifstream in(fileName, std::ios::binary);
+   char magic[LONGSIZE] = {0};
+   in.read(magic, LONGSIZE);
+   if (!in.good() || std::string(magic, LONGSIZE) != "YESSLOG1") return false;
+   uint64_t interval = readLong(in);
+
+   in.seekg(0, std::ios::end);
+   uint64_t size = in.tellg();
+   in.seekg(-3 * LONGSIZE, std::ios::end);
+   uint64_t cycles = readLong(in);
+   uint64_t numKeyframes = readLong(in);
+   uint64_t indexOffset = readLong(in);
+   if (!in.good() || interval == 0 || first >= cycles || last >= cycles)
+      return false;
+
+   //record writes a keyframe every interval cycles and the index and
+   //trailer end the file; anything else is a damaged log, and reading
+   //it would allocate or seek according to garbage
+   if (numKeyframes != (cycles - 1) / interval + 1 ||
+       numKeyframes > size / LONGSIZE ||
+       indexOffset < 2 * LONGSIZE ||
+       indexOffset + (numKeyframes + 3) * LONGSIZE != size)
+      return false;
+   std::vector<uint64_t> keyframes(numKeyframes);
+   in.seekg(indexOffset);
+   for (uint64_t i = 0; i < numKeyframes; i++)
+   {
+      keyframes[i] = readLong(in);
+      if (keyframes[i] < 2 * LONGSIZE || keyframes[i] >= indexOffset)
+         return false;
+   }
+
+   bindFields(machine);
+   uint64_t current = cycles;    //cycle held in slots; none yet
+   for (uint64_t cycle = first; ; cycle = first <= last ? cycle + 1 : cycle - 1)
+   {
+      if (current == cycles || cycle != current + 1)
+      {
+         //start from the keyframe at or before cycle
+         uint64_t key = cycle / interval;
+         in.clear();
+         in.seekg(keyframes[key]);
+         for (int32_t i = 0; i < NUMSLOTS; i++) slots[i] = 0;
+         current = key * interval;
+         if (!readRecord(in)) return false;
+      }
+      while (current < cycle)
+      {
+         current++;
+         if (current % interval == 0)
+            for (int32_t i = 0; i < NUMSLOTS; i++) slots[i] = 0;
+         if (!readRecord(in)) return false;
+      }
+
+      restore(machine);
+      std::cout << "\nAt end of cycle " << std::dec << cycle << ":"
+                << std::endl;
+      for (int32_t i = 0; i < NUMPIPEREGS; i++)
+         machine.getPipeReg(i)->dump(std::cout);
+      ConditionCodes::getInstance()->dump();
+      RegisterFile::getInstance()->dump();
+      Memory::getInstance()->dump();
+      if (cycle == last) break;
+   }
+   return true;
+}
@@ -0,0 +1,55 @@
+#include <cstdint>
+#include <fstream>
+#include <vector>
+#include "Tools.h"
+#include "DirtyWords.h"
+#ifndef REPLAYLOG_H
+#define REPLAYLOG_H
+
+//slots of the recorded state: pipeline register fields, registers,
+//condition codes (ZF | SF << 1 | OF << 2) and memory words
+#define FIELDSLOT 0
+#define REGSLOT NUMFIELDS
+#define CCSLOT (REGSLOT + REGSIZE)
+#define MEMSLOT (CCSLOT + 1)
+#define NUMSLOTS (MEMSLOT + MEMWORDS)
+//default number of cycles between keyframes
+#define KEYINTERVAL 1024
+
+class Machine;
+class PipeReg;
+class PipeRegField;
+
+//log of the state changes made by each cycle of the PIPE machine.
+//Each cycle is a record of (slot, value) pairs for the slots that
+//changed; every interval cycles the record holds the whole state
+//(a keyframe) so that any cycle can be rebuilt from the keyframe
+//before it without simulating.
+class ReplayLog
+{
+   private:
+      static ReplayLog * logInstance;
+      ReplayLog();
+      PipeRegField * fields[NUMFIELDS];
+      uint64_t slots[NUMSLOTS];           //state at the end of the last cycle
+      DirtyWords dirty;                   //words stored to in this cycle
+      void bindFields(Machine & machine);
+      void capture(Machine & machine, std::vector<uint64_t> & changes,
+                   bool keyframe);
+      void restore(Machine & machine);
+      static void writeLong(std::ostream & out, uint64_t value);
+      static uint64_t readLong(std::istream & in);
+      bool readRecord(std::istream & in);
+   public:
+      //fields of each pipeline register, in the order of bindFields
+      static const int32_t numFields[NUMPIPEREGS];
+      static ReplayLog * getInstance();
+      static void bindFields(PipeReg * pregs[], PipeRegField * fields[]);
+      static void writeVarint(std::ostream & out, uint64_t value);
+      static bool readVarint(std::istream & in, uint64_t & value);
+      bool record(Machine & machine, const char * fileName,
+                  uint64_t interval);
+      bool replay(Machine & machine, const char * fileName,
+                  uint64_t first, uint64_t last);
+};
+#endif
@@ -0,0 +1,205 @@
+#include <iostream>
+#include <iomanip>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include "Memory.h"
+#include "RegisterFile.h"
+#include "ConditionCodes.h"
+#include "Status.h"
+#include "PipeRegField.h"
+#include "PipeReg.h"
+#include "Stage.h"
+#include "W.h"
+#include "Simulate.h"
+#include "Executor.h"
+#include "Interpreter.h"
+#include "MachineState.h"
+#include "Sampler.h"
+
+/*
+ * The Sampler estimates the number of pipeline cycles a program takes
+ * without simulating every cycle. The Interpreter executes the whole
+ * program. At the start of every period the architectural state is
+ * saved and the pipeline is started at the Interpreter's PC: the
+ * first warmup instructions fill the pipeline and the cycles taken by
+ * the next window instructions are measured. The pipeline does not
+ * squash, so it also retires instructions the program does not
+ * execute; the Executor lists the instructions of the warmup and the
+ * window first and only those are counted as they reach the W
+ * register. The saved state is then
+ * restored and the Interpreter executes the same instructions and
+ * fast-forwards to the next period, so the final state is the one
+ * produced by the Interpreter. The CPI of the windows estimates the
+ * CPI of the program, and the spread of the window CPIs gives a 95%
+ * confidence interval for it. If the program halts while the pipeline
+ * is running, the cycles of that last detailed run are exact and are
+ * used for the end of the program instead of the estimate.
+ */
+
+/*
+ * Sampler constructor
+ *
+ * @param period - instructions from the start of one window to the next
+ * @param warmup - detailed instructions executed before each window
+ * @param window - instructions measured in each window; warmup +
+ *                 window must not exceed period
+ */
+Sampler::Sampler(uint64_t period, uint64_t warmup, uint64_t window)
+{
+   interpreter = new Interpreter();
+   detail = new Simulate();
+   saved = new MachineState();
+   this->period = period;
+   this->warmup = warmup;
+   this->window = window;
+   detailInstructions = 0;
+   tail = false;
+   tailStart = 0;
+   tailCycles = 0;
+}
+
+/*
+ * run
+ * executes the program from address 0 until the status is no longer
+ * SAOK, measuring one window per period
+ */
+void Sampler::run()
+{
+   interpreter->reset();
+   while (interpreter->getStat() == SAOK)
+   {
+      measure();
+      interpreter->runFor(warmup + window);
+      interpreter->runFor(period - warmup - window);
+   }
+}
+
+/*
+ * measure
+ * runs the pipeline from the Interpreter's PC until the next warmup +
+ * window instructions of the program have reached the W register and
+ * records the CPI of the window: the cycles from the last warmup
+ * instruction to the last window instruction reaching W, over the
+ * window instructions. If the program stops in those instructions,
+ * the cycles to the end of the program are recorded instead. The
+ * architectural state is left as it was before the call.
+ */
+void Sampler::measure()
+{
+   Executor executor;
+   InstrRecord r;
+   W * wreg = (W *) detail->getPipeReg(WREG);
+
+   saved->save();
+   executor.setPC(interpreter->getPC());
+   pcs.clear();
+   do
+   {
+      executor.step(r);
+      pcs.push_back(r.pc);
+   } while (r.stat == SAOK && pcs.size() < warmup + window);
+   saved->restore();
+
+   bool stop = false;
+   uint64_t matched = 0, cycle = 0, from = 0, to = 0;
+   uint64_t start = warmup > 0 ? warmup - 1 : 0;
+   detail->reset(interpreter->getPC());
+   while (!stop && (r.stat != SAOK || matched < pcs.size()) &&
+          cycle < SAMPLEMAXCPI * pcs.size() + NUMPIPEREGS)
+   {
+      if (matched < pcs.size() && wreg->getpc()->getOutput() == pcs[matched])
+      {
+         if (matched == start) from = cycle;
+         to = cycle;
+         matched++;
+      }
+      stop = detail->doClockLow();
+      detail->doClockHigh();
+      cycle++;
+   }
+   if (r.stat != SAOK)
+   {
+      tail = true;
+      tailStart = interpreter->getInstructions();
+      tailCycles = cycle;
+   }
+   else if (matched > start + 1)
+      cpi.push_back((double) (to - from) / (matched - 1 - start));
+   detailInstructions += detail->getRetired();
+   saved->restore();
+}
+
+/*
+ * getMeanCPI
+ * @return average of the window CPIs
+ */
+double Sampler::getMeanCPI()
+{
+   double sum = 0;
+   for (uint64_t i = 0; i < cpi.size(); i++) sum += cpi[i];
+   return cpi.size() > 0 ? sum / cpi.size() : 0;
+}
+
+/*
+ * getCPIError
+ * @return half-width of the 95% confidence interval of the mean CPI
+ *         (0 if fewer than two windows were measured)
+ */
+double Sampler::getCPIError()
+{
+   if (cpi.size() < 2) return 0;
+   double mean = getMeanCPI();
+   double sum = 0;
+   for (uint64_t i = 0; i < cpi.size(); i++)
+      sum += (cpi[i] - mean) * (cpi[i] - mean);
+   double deviation = std::sqrt(sum / (cpi.size() - 1));
+   return ZSCORE95 * deviation / std::sqrt((double) cpi.size());
+}
+
+/*
+ * getEstimatedCycles
+ * @return estimated number of cycles the pipeline takes to run the
+ *         program: the mean CPI times the number of instructions that
+ *         were not run to the halt in the pipeline, plus the exact
+ *         cycles of that last run (or of filling the pipeline)
+ */
+uint64_t Sampler::getEstimatedCycles()
+{
+   uint64_t estimated = tail ? tailStart : interpreter->getInstructions();
+   return (uint64_t) std::llround(getMeanCPI() * estimated) +
+          (tail ? tailCycles : NUMPIPEREGS - 1);
+}
+
+/*
+ * getCyclesError
+ * @return half-width of the 95% confidence interval of the estimated
+ *         number of cycles
+ */
+uint64_t Sampler::getCyclesError()
+{
+   uint64_t estimated = tail ? tailStart : interpreter->getInstructions();
+   return (uint64_t) std::llround(getCPIError() * estimated);
+}
+
+/*
+ * dump
+ * outputs the estimate followed by the condition codes, register
+ * file and memory produced by the Interpreter
+ */
+void Sampler::dump()
+{
+   std::cout << "\nAt end of sampled run:" << std::endl;
+   std::cout << "stat: " << std::hex << interpreter->getStat() << " pc: "
+             << std::setw(3) << std::setfill('0') << interpreter->getPC()
+             << std::dec << " instructions: "
+             << interpreter->getInstructions() << " windows: "
+             << cpi.size() << " detailed instructions: "
+             << detailInstructions << std::endl;
+   std::cout << "CPI: " << getMeanCPI() << " +/- " << getCPIError()
+             << " estimated cycles: " << getEstimatedCycles() << " +/- "
+             << getCyclesError() << " (95% confidence)" << std::endl;
+   ConditionCodes::getInstance()->dump();
+   RegisterFile::getInstance()->dump();
+   Memory::getInstance()->dump();
+}
@@ -0,0 +1,43 @@
+#include <cstdint>
+#include <vector>
+#ifndef SAMPLER_H
+#define SAMPLER_H
+
+//default sampling parameters, in instructions
+#define SAMPLEPERIOD 100000  //distance between the starts of two windows
+#define SAMPLEWARMUP 100     //detailed instructions before each window
+#define SAMPLEWINDOW 1000    //detailed instructions measured per window
+
+//normal quantile used for the 95% confidence interval
+#define ZSCORE95 1.96
+//most cycles per instruction the pipeline is run for in a window
+#define SAMPLEMAXCPI 8
+
+//runs a program with the Interpreter and periodically switches to the
+//pipeline to measure the CPI of a window of instructions
+class Sampler
+{
+   private:
+      Interpreter * interpreter;
+      Simulate * detail;
+      MachineState * saved;
+      uint64_t period;
+      uint64_t warmup;
+      uint64_t window;
+      std::vector<double> cpi;   //CPI measured in each window
+      std::vector<uint64_t> pcs; //instructions of the window being measured
+      uint64_t detailInstructions;
+      bool tail;                 //true if the program halted in the pipeline
+      uint64_t tailStart;        //instructions executed before that run
+      uint64_t tailCycles;       //cycles that run took
+      void measure();
+   public:
+      Sampler(uint64_t period, uint64_t warmup, uint64_t window);
+      void run();
+      double getMeanCPI();
+      double getCPIError();
+      uint64_t getEstimatedCycles();
+      uint64_t getCyclesError();
+      void dump();
+};
+#endif
@@ -19,6 +19,7 @@
 #include "M.h"
 #include "W.h"
 #include "Stage.h"
+#include "InstrTable.h"
 #include "ExecuteStage.h"
 #include "MemoryStage.h"
 #include "DecodeStage.h"
@@ -28,6 +29,11 @@
 #include "Memory.h"
 #include "RegisterFile.h"
 #include "ConditionCodes.h"
+#include "Forwarding.h"
+#include "Profiler.h"
+#include "CallProfile.h"
+#include "ReplayLog.h"
+#include "Energy.h"
 
 /*
  * Simulate constructor
@@ -51,6 +57,38 @@ Simulate::Simulate()
    pregs[EREG] = new E();
    pregs[MREG] = new M();
    pregs[WREG] = new W();
+
+   fill = NUMPIPEREGS - 1;
+   retired = 0;
+}
+
+/*
+ * Simulate destructor
+ *
+ * frees the stages and pipeline registers
+ */
+Simulate::~Simulate()
+{
+   for (int32_t i = 0; i < NUMSTAGES; i++) delete stages[i];
+   for (int32_t i = 0; i < NUMPIPEREGS; i++) delete pregs[i];
+   delete [] stages;
+   delete [] pregs;
+}
+
+/*
+ * reset
+ *
+ * empties the pipeline so that the next cycle fetches the
+ * instruction at pc and clears the count of retired instructions
+ *
+ * @param pc - address of the first instruction to fetch
+*/
+void Simulate::reset(uint64_t pc)
+{
+   for (int32_t i = 0; i < NUMPIPEREGS; i++) pregs[i]->reset();
+   ((F *) pregs[FREG])->getpredPC()->bubble(pc);
+   fill = NUMPIPEREGS - 1;
+   retired = 0;
 }
 
 /* 
@@ -75,12 +113,35 @@ void Simulate::run()
       /* Register File, and Memory */
       std::cout << "\nAt end of cycle " << std::dec 
          << cycle << ":" << std::endl;
-      dumpPipeRegs();
-      cc->dump();
-      rf->dump();
-      mem->dump();
+      PROFILE(PROFPIPEREGS, dumpPipeRegs());
+      PROFILE(PROFCC, cc->dump());
+      PROFILE(PROFREGS, rf->dump());
+      PROFILE(PROFMEMORY, mem->dump());
+      cycle++;
+   }
+}
+
+/* 
+ * runQuiet
+ * 
+ * Simulate the stages of the PIPE machine until a halt is executed
+ * or maxCycles cycles have been simulated, without dumping any state.
+ *
+ * @param maxCycles - maximum number of cycles to simulate
+ * @return number of cycles simulated
+*/
+uint64_t Simulate::runQuiet(uint64_t maxCycles)
+{
+   uint64_t cycle = 0;
+   bool stop = false;
+
+   while (!stop && cycle < maxCycles)
+   {
+      stop = doClockLow();
+      doClockHigh();
       cycle++;
    }
+   return cycle;
 }
 
 /*
@@ -95,11 +156,23 @@ bool Simulate::doClockLow()
 
    //going through the stages in reverse order helps to
    //simulate the parallel behavior of the hardware
-   stop = stages[WSTAGE]->doClockLow(pregs, stages);
-   stages[MSTAGE]->doClockLow(pregs, stages);
-   stages[ESTAGE]->doClockLow(pregs, stages);
-   stages[DSTAGE]->doClockLow(pregs, stages);
-   stages[FSTAGE]->doClockLow(pregs, stages);
+   PROFILE(PROFLOW + WSTAGE, stop = stages[WSTAGE]->doClockLow(pregs, stages));
+   //the W register holds the initial nops until the pipeline fills;
+   //after that it holds one instruction every cycle
+   if (fill > 0) fill--;
+   else retired++;
+   if (CallProfile::isEnabled())
+   {
+      W * wreg = (W *) pregs[WREG];
+      CallProfile::getInstance()->retire(wreg->geticode()->getOutput(),
+                                         wreg->getpc()->getOutput());
+   }
+   PROFILE(PROFLOW + MSTAGE, stages[MSTAGE]->doClockLow(pregs, stages));
+   PROFILE(PROFLOW + ESTAGE, stages[ESTAGE]->doClockLow(pregs, stages));
+   PROFILE(PROFLOW + DSTAGE, stages[DSTAGE]->doClockLow(pregs, stages));
+   //a decode stall sends a bubble that W must not count as retired
+   if (Forwarding::getInstance()->isStalling()) fill++;
+   PROFILE(PROFLOW + FSTAGE, stages[FSTAGE]->doClockLow(pregs, stages));
    return stop;
 }
 
@@ -114,19 +187,21 @@ bool Simulate::doClockLow()
 void Simulate::doClockHigh()
 {
    //get the WritebackStage to update the register file
-   stages[WSTAGE]->doClockHigh(pregs);
+   PROFILE(PROFHIGH + WSTAGE, stages[WSTAGE]->doClockHigh(pregs));
 
    //get the MemoryStage to update the W register
-   stages[MSTAGE]->doClockHigh(pregs);
+   PROFILE(PROFHIGH + MSTAGE, stages[MSTAGE]->doClockHigh(pregs));
 
    //get the ExecuteStage to update the M register
-   stages[ESTAGE]->doClockHigh(pregs);
+   PROFILE(PROFHIGH + ESTAGE, stages[ESTAGE]->doClockHigh(pregs));
 
    //get the DecodeStage to update the E register
-   stages[DSTAGE]->doClockHigh(pregs);
+   PROFILE(PROFHIGH + DSTAGE, stages[DSTAGE]->doClockHigh(pregs));
 
    //get the FetchStage to update the F and D registers
-   stages[FSTAGE]->doClockHigh(pregs);
+   PROFILE(PROFHIGH + FSTAGE, stages[FSTAGE]->doClockHigh(pregs));
+
+   if (Energy::isEnabled()) Energy::getInstance()->clocked(pregs);
 }
 
 /*
@@ -136,9 +211,42 @@ void Simulate::doClockHigh()
 */
 void Simulate::dumpPipeRegs()
 {
-   pregs[FREG]->dump();
-   pregs[DREG]->dump();
-   pregs[EREG]->dump();
-   pregs[MREG]->dump();
-   pregs[WREG]->dump();
+   pregs[FREG]->dump(std::cout);
+   pregs[DREG]->dump(std::cout);
+   pregs[EREG]->dump(std::cout);
+   pregs[MREG]->dump(std::cout);
+   pregs[WREG]->dump(std::cout);
+}
+
+/*
+ * getRetired
+ *
+ * @return number of instructions that have reached the writeback
+ *         stage since the Simulate object was created or reset
+*/
+uint64_t Simulate::getRetired()
+{
+   return retired;
+}
+
+/*
+ * getPipeReg
+ *
+ * @param index - FREG, DREG, EREG, MREG or WREG
+ * @return the pipelined register at index
+*/
+PipeReg * Simulate::getPipeReg(int32_t index)
+{
+   return pregs[index];
+}
+
+/*
+ * getStage
+ *
+ * @param index - FSTAGE, DSTAGE, ESTAGE, MSTAGE or WSTAGE
+ * @return the stage at index
+*/
+Stage * Simulate::getStage(int32_t index)
+{
+   return stages[index];
 }
@@ -4,10 +4,21 @@ class Simulate
    private:
       PipeReg ** pregs;
       Stage ** stages;
+      uint64_t fill;       //cycles until the first fetched instruction
+                           //reaches the W register
+      uint64_t retired;    //instructions that have reached writeback
    public:
       Simulate();
+      ~Simulate();
+      Simulate(const Simulate &) = delete;
+      Simulate & operator=(const Simulate &) = delete;
+      void reset(uint64_t pc);
       void run();
+      uint64_t runQuiet(uint64_t maxCycles);
       bool doClockLow();
       void doClockHigh();
       void dumpPipeRegs();
+      uint64_t getRetired();
+      PipeReg * getPipeReg(int32_t index);
+      Stage * getStage(int32_t index);
 };
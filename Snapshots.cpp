@@ -0,0 +1,107 @@
+#include <iostream>
+#include <cstdint>
+#include <string.h>
+#include "Memory.h"
+#include "RegisterFile.h"
+#include "ConditionCodes.h"
+#include "Tools.h"
+#include "PipeRegField.h"
+#include "PipeReg.h"
+#include "F.h"
+#include "D.h"
+#include "E.h"
+#include "M.h"
+#include "W.h"
+#include "Machine.h"
+#include "ReplayLog.h"
+#include "Snapshots.h"
+#include "Profiler.h"
+
+/*
+ * Snapshots constructor
+ * binds the fields of the machine's pipeline registers, creates the
+ * registers snapshots are dumped from and starts mirroring the memory
+ *
+ * @param machine - machine whose state take copies
+ */
+Snapshots::Snapshots(Machine * machine)
+{
+   this->machine = machine;
+
+   PipeReg * machineRegs[NUMPIPEREGS];
+   for (int32_t i = 0; i < NUMPIPEREGS; i++)
+      machineRegs[i] = machine->getPipeReg(i);
+   source = new PipeRegField * [NUMFIELDS];
+   ReplayLog::bindFields(machineRegs, source);
+
+   pregs = new PipeReg * [NUMPIPEREGS];
+   pregs[FREG] = new F();
+   pregs[DREG] = new D();
+   pregs[EREG] = new E();
+   pregs[MREG] = new M();
+   pregs[WREG] = new W();
+   fields = new PipeRegField * [NUMFIELDS];
+   ReplayLog::bindFields(pregs, fields);
+
+   bool error = false;
+   for (int32_t i = 0; i < MEMWORDS; i++)
+      words[i] = machine->getLong(i * LONGSIZE, error);
+   Memory::getInstance()->addObserver(&dirty);
+}
+
+/*
+ * Snapshots destructor
+ * stops mirroring the memory and frees the registers snapshots are
+ * dumped from
+ */
+Snapshots::~Snapshots()
+{
+   Memory::getInstance()->removeObserver(&dirty);
+   for (int32_t i = 0; i < NUMPIPEREGS; i++) delete pregs[i];
+   delete [] pregs;
+   delete [] fields;
+   delete [] source;
+}
+
+/*
+ * take
+ * copies the state of the machine at the end of the last cycle it
+ * simulated into snapshot
+ */
+void Snapshots::take(Snapshot & snapshot)
+{
+   bool error = false;
+   snapshot.cycle = machine->getCycle() - 1;
+   for (int32_t i = 0; i < NUMFIELDS; i++)
+      snapshot.fields[i] = source[i]->getOutput();
+   for (int32_t i = 0; i < REGSIZE; i++)
+      snapshot.reg[i] = machine->readRegister(i, error);
+   snapshot.codes = (uint64_t) machine->getConditionCode(ZF, error) << ZF |
+                    (uint64_t) machine->getConditionCode(SF, error) << SF |
+                    (uint64_t) machine->getConditionCode(OF, error) << OF;
+   const std::vector<uint64_t> & stored = dirty.getWords();
+   for (uint64_t i = 0; i < stored.size(); i++)
+      words[stored[i]] = machine->getLong(stored[i] * LONGSIZE, error);
+   dirty.clear();
+   memcpy(snapshot.words, words, sizeof(words));
+}
+
+/*
+ * format
+ * outputs snapshot to out in the format of Machine::dump
+ */
+void Snapshots::format(Snapshot & snapshot, std::ostream & out)
+{
+   for (int32_t i = 0; i < NUMFIELDS; i++)
+   {
+      fields[i]->setInput(snapshot.fields[i]);
+      fields[i]->normal();
+   }
+   out << "\nAt end of cycle " << std::dec << snapshot.cycle << ":"
+       << std::endl;
+   PROFILE(PROFPIPEREGS,
+           for (int32_t i = 0; i < NUMPIPEREGS; i++) pregs[i]->dump(out));
+   PROFILE(PROFCC, ConditionCodes::dump(out, snapshot.codes));
+   PROFILE(PROFREGS, RegisterFile::dump(out, snapshot.reg));
+   PROFILE(PROFMEMORY, Memory::dump(out, snapshot.words));
+}
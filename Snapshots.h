@@ -0,0 +1,45 @@
+#include <cstdint>
+#include <ostream>
+#include "Tools.h"
+#include "DirtyWords.h"
+#ifndef SNAPSHOTS_H
+#define SNAPSHOTS_H
+
+class Machine;
+class PipeReg;
+class PipeRegField;
+
+//state of the machine at the end of a cycle
+struct Snapshot
+{
+   uint64_t cycle;
+   uint64_t fields[NUMFIELDS];      //in the order of ReplayLog::bindFields
+   uint64_t reg[REGSIZE];
+   uint64_t codes;                  //ZF, SF and OF at their bit positions
+   uint64_t words[MEMWORDS];
+};
+
+//copies the state of a machine into Snapshots and outputs a snapshot
+//in the format of Machine::dump. Copying is cheap next to formatting:
+//the memory is mirrored, rereading only the words stored to since the
+//last copy, so a snapshot can be kept and only formatted if it is
+//needed. The formatting uses pipeline registers of its own, so it can
+//run while the machine goes on.
+class Snapshots
+{
+   private:
+      Machine * machine;
+      uint64_t words[MEMWORDS];       //memory at the last take
+      DirtyWords dirty;               //words stored to since then
+      PipeRegField ** source;         //fields of the machine's registers
+      PipeReg ** pregs;               //registers a snapshot is dumped from
+      PipeRegField ** fields;         //fields of pregs
+   public:
+      Snapshots(Machine * machine);
+      ~Snapshots();
+      Snapshots(const Snapshots &) = delete;
+      Snapshots & operator=(const Snapshots &) = delete;
+      void take(Snapshot & snapshot);
+      void format(Snapshot & snapshot, std::ostream & out);
+};
+#endif
@@ -10,6 +10,7 @@
 class Stage
 {
    public:
+      virtual ~Stage() {}
       //abstract methods implemented in the descendant classes
       //virtual makes these methods polymorphic       
       virtual bool doClockLow(PipeReg ** pregs, Stage ** stages) = 0;
@@ -0,0 +1,254 @@
+#include <string>
+#include <vector>
+#include <ostream>
+#include <cstdint>
+#include <stdio.h>
+#include <stdlib.h>
+#include "Memory.h"
+#include "RegisterFile.h"
+#include "ConditionCodes.h"
+#include "Tools.h"
+#include "PipeRegField.h"
+#include "PipeReg.h"
+#include "Machine.h"
+#include "ReplayLog.h"
+#include "StateExport.h"
+
+//names of the pipeline register fields in the order of
+//ReplayLog::bindFields
+static const char * fieldNames[NUMFIELDS] = {
+   "F.predPC",
+   "D.stat", "D.icode", "D.ifun", "D.rA", "D.rB", "D.valC", "D.valP",
+   "E.stat", "E.icode", "E.ifun", "E.valC", "E.valA", "E.valB", "E.dstE",
+   "E.dstM", "E.srcA", "E.srcB",
+   "M.stat", "M.icode", "M.Cnd", "M.valE", "M.valA", "M.dstE", "M.dstM",
+   "W.stat", "W.icode", "W.valE", "W.valM", "W.dstE", "W.dstM"
+};
+
+static const char * regNames[REGSIZE] = {
+   "rax", "rcx", "rdx", "rbx", "rsp", "rbp", "rsi", "rdi",
+   "r8", "r9", "r10", "r11", "r12", "r13", "r14"
+};
+
+static const char * ccNames[3] = {"ZF", "SF", "OF"};
+static const int32_t ccNums[3] = {ZF, SF, OF};
+
+/*
+ * StateExport constructor
+ *
+ * @param format - EXPORTJSON or EXPORTCSV
+ */
+StateExport::StateExport(int32_t format)
+{
+   this->format = format;
+   for (int32_t i = 0; i < NUMFIELDS; i++) fields[i] = NULL;
+}
+
+/*
+ * parseFormat
+ * sets format to the format named name ("json" or "csv")
+ *
+ * @return false if name is not a format
+ */
+bool StateExport::parseFormat(const char * name, int32_t & format)
+{
+   std::string s = name;
+   if (s == "json") format = EXPORTJSON;
+   else if (s == "csv") format = EXPORTCSV;
+   else return false;
+   return true;
+}
+
+/*
+ * addColumns
+ * adds the columns selected by name: a field such as "D.icode", a
+ * whole register ("D"), a register ("rax"), "regs" for all of them, a
+ * condition code ("ZF"), "cc" for all of them, a word address ("0x018"),
+ * "mem" for the nonzero words (JSON only) or "all"
+ *
+ * @return false if name selects nothing
+ */
+bool StateExport::addColumns(const std::string & name)
+{
+   bool found = false;
+   if (name == "all")
+   {
+      const char * all[] = {"F", "D", "E", "M", "W", "regs", "cc", "mem"};
+      for (int32_t i = 0; i < (format == EXPORTJSON ? 8 : 7); i++)
+         addColumns(all[i]);
+      return true;
+   }
+   for (int32_t i = 0; i < NUMFIELDS; i++)
+   {
+      std::string field = fieldNames[i];
+      if (name == field || name == field.substr(0, 1))
+      {
+         columns.push_back({field, COLFIELD, i});
+         found = true;
+      }
+   }
+   for (int32_t i = 0; i < REGSIZE; i++)
+   {
+      if (name == regNames[i] || name == "regs")
+      {
+         columns.push_back({regNames[i], COLREG, i});
+         found = true;
+      }
+   }
+   for (int32_t i = 0; i < 3; i++)
+   {
+      if (name == ccNames[i] || name == "cc")
+      {
+         columns.push_back({ccNames[i], COLCC, ccNums[i]});
+         found = true;
+      }
+   }
+   if (name == "mem" && format == EXPORTJSON)
+   {
+      columns.push_back({name, COLMEMORY, 0});
+      found = true;
+   }
+   if (name.compare(0, 2, "0x") == 0 && name.length() > 2)
+   {
+      char * end;
+      unsigned long address = strtoul(name.c_str(), &end, 16);
+      if (*end == '\0' && address % LONGSIZE == 0 && address < MEMSIZE)
+      {
+         char key[8];
+         snprintf(key, sizeof(key), "0x%03lx", address);
+         columns.push_back({key, COLWORD, (int32_t) address});
+         found = true;
+      }
+   }
+   return found;
+}
+
+/*
+ * select
+ * sets the values exported to those selected by the comma separated
+ * list names (see addColumns); by default every pipeline register
+ * field, register and condition code and, in JSON, the nonzero
+ * memory words are exported
+ *
+ * @return false if a name in the list selects nothing
+ */
+bool StateExport::select(const char * names)
+{
+   std::string list = names;
+   uint64_t start = 0;
+   columns.clear();
+   while (start <= list.length())
+   {
+      uint64_t end = list.find(',', start);
+      if (end == std::string::npos) end = list.length();
+      if (!addColumns(list.substr(start, end - start))) return false;
+      start = end + 1;
+   }
+   return true;
+}
+
+/*
+ * appendValue
+ * appends value to line: in JSON a string of hex digits ("0x1f"), since
+ * JSON numbers are doubles in most readers and lose the low bits of
+ * large 64-bit values; in CSV an unsigned decimal number
+ */
+void StateExport::appendValue(uint64_t value, std::string & line)
+{
+   char text[24];
+   if (format == EXPORTJSON)
+      snprintf(text, sizeof(text), "\"0x%llx\"", (unsigned long long) value);
+   else
+      snprintf(text, sizeof(text), "%llu", (unsigned long long) value);
+   line += text;
+}
+
+/*
+ * appendLine
+ * appends the line of cycle, ending with a newline, to line
+ */
+void StateExport::appendLine(Machine & machine, uint64_t cycle,
+                             std::string & line)
+{
+   bool json = format == EXPORTJSON;
+   bool error = false;
+   line += json ? "{\"cycle\":" : "";
+   line += std::to_string(cycle);
+   for (uint64_t i = 0; i < columns.size(); i++)
+   {
+      const ExportColumn & column = columns[i];
+      uint64_t value = 0;
+      line += json ? ",\"" + column.name + "\":" : ",";
+      switch (column.kind)
+      {
+         case COLFIELD:
+            value = fields[column.index]->getOutput();
+            break;
+         case COLREG:
+            value = machine.readRegister(column.index, error);
+            break;
+         case COLCC:
+            value = machine.getConditionCode(column.index, error);
+            break;
+         case COLWORD:
+            value = machine.getLong(column.index, error);
+            break;
+         case COLMEMORY:
+         {
+            char key[16];
+            const char * separator = "";
+            line += "{";
+            for (int32_t address = 0; address < MEMSIZE; address += LONGSIZE)
+            {
+               value = machine.getLong(address, error);
+               if (value == 0) continue;
+               snprintf(key, sizeof(key), "%s\"0x%03x\":", separator, address);
+               line += key;
+               appendValue(value, line);
+               separator = ",";
+            }
+            line += "}";
+            continue;
+         }
+      }
+      appendValue(value, line);
+   }
+   line += json ? "}\n" : "\n";
+}
+
+/*
+ * run
+ * runs machine until a halt reaches the writeback stage or cycle last
+ * has been simulated, writing the selected values at the end of
+ * cycles first, first + step, ... up to last to out. A CSV export
+ * starts with a line of the column names.
+ */
+void StateExport::run(Machine & machine, uint64_t first, uint64_t last,
+                      uint64_t step, std::ostream & out)
+{
+   PipeReg * pregs[NUMPIPEREGS];
+   std::string line;
+   uint64_t cycle = 0;
+
+   if (columns.size() == 0) addColumns("all");
+   for (int32_t i = 0; i < NUMPIPEREGS; i++) pregs[i] = machine.getPipeReg(i);
+   ReplayLog::bindFields(pregs, fields);
+   if (format == EXPORTCSV)
+   {
+      line = "cycle";
+      for (uint64_t i = 0; i < columns.size(); i++) line += "," + columns[i].name;
+      out << line << "\n";
+   }
+   while (!machine.isHalted() && cycle <= last)
+   {
+      machine.step(1);
+      if (cycle >= first && (cycle - first) % step == 0)
+      {
+         line.clear();
+         appendLine(machine, cycle, line);
+         out << line;
+      }
+      cycle++;
+   }
+   out.flush();
+}
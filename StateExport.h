@@ -0,0 +1,53 @@
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <ostream>
+#ifndef STATEEXPORT_H
+#define STATEEXPORT_H
+
+//formats of the exported state
+#define EXPORTJSON 0      //a JSON object per line
+#define EXPORTCSV 1       //a header line, then comma separated values
+
+//kinds of column
+#define COLFIELD 0        //a pipeline register field
+#define COLREG 1          //a register
+#define COLCC 2           //a condition code
+#define COLWORD 3         //the memory word at an address
+#define COLMEMORY 4       //every nonzero memory word (JSON only)
+
+class Machine;
+class PipeRegField;
+
+//a value that is exported each cycle
+struct ExportColumn
+{
+   std::string name;
+   int32_t kind;     //COLFIELD, ...
+   int32_t index;    //field, register, condition code or address
+};
+
+//writes the state of the PIPE machine at the end of selected cycles
+//in a machine readable format, reading the selected pipeline register
+//fields, registers, condition codes and memory words directly. The
+//cycle is a number; in JSON every other value is a string of hex
+//digits ("0x1f") so that no reader rounds a 64-bit value, and in CSV
+//an unsigned decimal number. Memory words are named by their address
+//in hex ("0x018").
+class StateExport
+{
+   private:
+      int32_t format;
+      std::vector<ExportColumn> columns;
+      PipeRegField * fields[NUMFIELDS];
+      bool addColumns(const std::string & name);
+      void appendValue(uint64_t value, std::string & line);
+      void appendLine(Machine & machine, uint64_t cycle, std::string & line);
+   public:
+      StateExport(int32_t format);
+      static bool parseFormat(const char * name, int32_t & format);
+      bool select(const char * names);
+      void run(Machine & machine, uint64_t first, uint64_t last,
+               uint64_t step, std::ostream & out);
+};
+#endif
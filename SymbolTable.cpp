@@ -0,0 +1,76 @@
+#include <cstdint>
+#include <string>
+#include <map>
+#include <stdio.h>
+#include "SymbolTable.h"
+
+SymbolTable * SymbolTable::symbolInstance = NULL;
+
+/*
+ * SymbolTable constructor
+ * starts with no labels
+ */
+SymbolTable::SymbolTable()
+{
+}
+
+/*
+ * getInstance
+ * if symbolInstance is NULL then creates a SymbolTable object
+ * and sets symbolInstance to point to it; returns symbolInstance
+ *
+ * @return symbolInstance
+ */
+SymbolTable * SymbolTable::getInstance()
+{
+   if (symbolInstance == NULL)
+   {
+      symbolInstance = new SymbolTable();
+   }
+   return symbolInstance;
+}
+
+/*
+ * add
+ * adds label at address unless the address already has a label
+ */
+void SymbolTable::add(uint64_t address, const std::string & label)
+{
+   labels.insert(std::make_pair(address, label));
+}
+
+/*
+ * find
+ * @param label - set to the label at address if it has one
+ * @return true if address has a label
+ */
+bool SymbolTable::find(uint64_t address, std::string & label)
+{
+   std::map<uint64_t, std::string>::iterator it = labels.find(address);
+   if (it == labels.end()) return false;
+   label = it->second;
+   return true;
+}
+
+/*
+ * name
+ * @return the label at address, or the address in the 0xHHH form of
+ *         a .yo file if it has none
+ */
+std::string SymbolTable::name(uint64_t address)
+{
+   std::string label;
+   if (find(address, label)) return label;
+   char buffer[24];
+   sprintf(buffer, "0x%03llx", (unsigned long long) address);
+   return buffer;
+}
+
+/*
+ * clear
+ * removes every label
+ */
+void SymbolTable::clear()
+{
+   labels.clear();
+}
@@ -0,0 +1,23 @@
+#include <cstdint>
+#include <string>
+#include <map>
+#ifndef SYMBOLTABLE_H
+#define SYMBOLTABLE_H
+
+//labels of the program in Memory. The Loader adds each label that
+//starts the comment column of a .yo line ("0x020:   | loop:") with
+//the address on that line; Machine::reset clears them.
+class SymbolTable
+{
+   private:
+      static SymbolTable * symbolInstance;
+      SymbolTable();
+      std::map<uint64_t, std::string> labels;   //first label at each address
+   public:
+      static SymbolTable * getInstance();
+      void add(uint64_t address, const std::string & label);
+      bool find(uint64_t address, std::string & label);
+      std::string name(uint64_t address);
+      void clear();
+};
+#endif
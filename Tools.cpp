@@ -330,3 +330,49 @@ bool Tools::subOverflow(uint64_t op1, uint64_t op2)
   }
   return false;
 }
+
+/*
+ * mulOverflow
+ * returns true if op1 * op2 would overflow assuming that op1 and op2
+ * contain 64-bit two's complement values and false otherwise
+ *
+ * for example, mulOverflow(0x4000000000000000, 2) returns 1
+ *              mulOverflow(0xffffffffffffffff, 0x8000000000000000) returns 1
+ *              mulOverflow(0xffffffffffffffff, 0x7fffffffffffffff) returns 0
+ *
+ * @param uint64_t op1 that is one of the operands of the multiplication
+ * @param uint64_t op2 that is the other operand of the multiplication
+ * @return true if op1 * op2 would result in an overflow
+ */
+bool Tools::mulOverflow(uint64_t op1, uint64_t op2)
+{
+  int64_t a = (int64_t) op1;
+  int64_t b = (int64_t) op2;
+  if (a == 0 || b == 0) return false;
+  if ((a == -1 && b == INT64_MIN) || (b == -1 && a == INT64_MIN)) return true;
+  int64_t product = (int64_t) (op1 * op2);
+  return product / b != a;
+}
+
+/*
+ * popCount
+ * returns the number of bits of source that are 1
+ *
+ * for example, popCount(0x0) returns 0
+ *              popCount(0x8000000000000001) returns 2
+ *              popCount(0xffffffffffffffff) returns 64
+ *
+ * @param uint64_t source whose bits are counted
+ * @return number of 1 bits in source
+ */
+uint64_t Tools::popCount(uint64_t source)
+{
+#if defined(__GNUC__)
+  return __builtin_popcountll(source);
+#else
+  source = source - ((source >> 1) & 0x5555555555555555);
+  source = (source & 0x3333333333333333) + ((source >> 2) & 0x3333333333333333);
+  source = (source + (source >> 4)) & 0x0f0f0f0f0f0f0f0f;
+  return (source * 0x0101010101010101) >> 56;
+#endif
+}
@@ -17,5 +17,7 @@ class Tools
       static uint64_t sign(uint64_t op);
       static bool addOverflow(uint64_t op1, uint64_t op2);
       static bool subOverflow(uint64_t op1, uint64_t op2);
+      static bool mulOverflow(uint64_t op1, uint64_t op2);
+      static uint64_t popCount(uint64_t source);
 };
 #endif
@@ -0,0 +1,782 @@
+#include <iostream>
+#include <iomanip>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <vector>
+#include <sys/mman.h>
+#include "Memory.h"
+#include "RegisterFile.h"
+#include "ConditionCodes.h"
+#include "Instructions.h"
+#include "Status.h"
+#include "Tools.h"
+#include "InstrTable.h"
+#include "Translator.h"
+
+/*
+ * The Translator runs a loaded program by dynamic binary translation.
+ * A Y86-64 basic block (the instructions up to and including the
+ * next jXX, call, ret or halt) is translated into x86-64 code the
+ * first time control reaches it. The Y86-64 register file and
+ * condition codes live in a TranslatorState that the translated code
+ * addresses through rbx; data memory is accessed through the Memory
+ * instance so address checking stays in one place. Block exits with a
+ * known target are chained by patching their jmp to go directly to
+ * the target's translation. A store into a translated byte flushes
+ * every translation.
+ *
+ * Registers used by the translated code:
+ *    rbx - pointer to the TranslatorState
+ *    rax, rcx, rdx, rsi, rdi, r8 - scratch
+ */
+
+//x86-64 register numbers
+#define HRAX 0
+#define HRCX 1
+#define HRDX 2
+#define HRBX 3
+#define HRSI 6
+#define HRDI 7
+#define HR8 8
+
+//x86-64 condition codes used with emitJcc (second byte of 0f 8x)
+#define JAE 0x83
+#define JE 0x84
+#define JLE 0x8e
+
+//offsets of the TranslatorState fields
+#define OFFPC ((int32_t) offsetof(TranslatorState, pc))
+#define OFFCC ((int32_t) offsetof(TranslatorState, cc))
+#define OFFSTAT ((int32_t) offsetof(TranslatorState, stat))
+#define OFFBUDGET ((int32_t) offsetof(TranslatorState, budget))
+#define OFFICOUNT ((int32_t) offsetof(TranslatorState, icount))
+#define OFFEXIT ((int32_t) offsetof(TranslatorState, exit))
+#define OFFFLUSHED ((int32_t) offsetof(TranslatorState, flushed))
+#define OFFREG(r) ((int32_t) (offsetof(TranslatorState, reg) + 8 * (r)))
+
+//bytes of translated code that a single instruction can need
+#define MAXINSTRCODE 160
+
+//enters the translated code: called as enter(&state, block)
+typedef void (* EnterFn)(TranslatorState *, uint8_t *);
+
+/*
+ * Translator constructor
+ *
+ * allocates the code buffer and emits the code that enters and
+ * leaves the translated blocks
+ */
+Translator::Translator()
+{
+   code = NULL;
+#if defined(__x86_64__)
+   void * buffer = mmap(NULL, CODESIZE, PROT_READ | PROT_WRITE | PROT_EXEC,
+                        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+   if (buffer != MAP_FAILED) code = (uint8_t *) buffer;
+#endif
+   memset(&state, 0, sizeof(state));
+   state.owner = this;
+   numBlocks = 0;
+   numFlushes = 0;
+   epilogue = NULL;
+   next = code;
+   if (code == NULL) return;
+
+   //enter: push rbx; mov rbx, rdi; jmp rsi
+   emit8(0x53);
+   emit8(0x48); emit8(0x89); emit8(0xfb);
+   emit8(0xff); emit8(0xe6);
+
+   //epilogue: pop rbx; ret
+   epilogue = next;
+   emit8(0x5b);
+   emit8(0xc3);
+   flush();
+   numFlushes = 0;
+}
+
+/*
+ * Translator destructor
+ *
+ * releases the code buffer
+ */
+Translator::~Translator()
+{
+   if (code != NULL) munmap(code, CODESIZE);
+}
+
+/*
+ * flush
+ * discards every translation
+ */
+void Translator::flush()
+{
+   for (int32_t i = 0; i < MEMSIZE; i++)
+   {
+      blockAt[i] = NULL;
+      codeMap[i] = 0;
+   }
+   slots.clear();
+   next = epilogue + 2;
+   numFlushes++;
+}
+
+/*
+ * run
+ * executes the program in Memory starting at address 0 with the
+ * register file and condition codes taken from the RegisterFile and
+ * ConditionCodes instances, until the status is no longer SAOK.
+ * The final register values and condition codes are written back.
+ */
+void Translator::run()
+{
+   RegisterFile * rf = RegisterFile::getInstance();
+   ConditionCodes * cc = ConditionCodes::getInstance();
+   bool error = false;
+
+   for (int32_t i = 0; i < REGSIZE; i++)
+      state.reg[i] = rf->readRegister(i, error);
+   state.reg[RNONE] = 0;
+   state.cc = cc->getConditionCode(ZF, error) |
+              cc->getConditionCode(SF, error) << 1 |
+              cc->getConditionCode(OF, error) << 2;
+   state.pc = 0;
+   state.stat = code == NULL ? SINS : SAOK;
+
+   while (state.stat == SAOK)
+   {
+      if (state.pc >= MEMSIZE)
+      {
+         state.stat = SADR;
+         break;
+      }
+      uint8_t * block = blockAt[state.pc];
+      if (block == NULL) block = translate(state.pc);
+      state.budget = QUANTUM;
+      state.exit = 0;
+      state.flushed = 0;
+      ((EnterFn) code)(&state, block);
+   }
+
+   for (int32_t i = 0; i < REGSIZE; i++)
+      rf->writeRegister(state.reg[i], i, error);
+   cc->setConditionCode(state.cc & 1, ZF, error);
+   cc->setConditionCode((state.cc >> 1) & 1, SF, error);
+   cc->setConditionCode((state.cc >> 2) & 1, OF, error);
+}
+
+/*
+ * translate
+ * translates the basic block that starts at pc
+ *
+ * @param pc - address of the first instruction of the block
+ * @return address of the translated code
+ */
+uint8_t * Translator::translate(uint64_t pc)
+{
+   Memory * mem = Memory::getInstance();
+
+   if (next + MAXBLOCKINSTRS * MAXINSTRCODE > code + CODESIZE) flush();
+
+   uint8_t * block = next;
+   blockAt[pc] = block;
+   numBlocks++;
+
+   //decode the whole block first so that its length is known
+   uint64_t pcs[MAXBLOCKINSTRS];
+   uint64_t count = 0;
+   uint64_t addr = pc;
+   bool end = false;
+   while (!end && count < MAXBLOCKINSTRS)
+   {
+      bool error = false;
+      uint8_t byte = mem->getByte(addr, error);
+      const InstrProps & props = InstrTable::lookup(byte >> 4, byte & 0xf);
+      pcs[count++] = addr;
+      if (error || !props.valid || addr + props.length > MEMSIZE) break;
+      for (uint64_t i = 0; i < props.length; i++) codeMap[addr + i] = 1;
+      end = (byte >> 4) == IJXX || (byte >> 4) == ICALL ||
+            (byte >> 4) == IRET || (byte >> 4) == IHALT;
+      addr += props.length;
+   }
+
+   //cmp qword [rbx + budget], 0; jle epilogue
+   emit8(0x48); emit8(0x83); emit8(0xbb); emit32(OFFBUDGET); emit8(0);
+   patch(emitJcc(JLE), epilogue);
+   //sub qword [rbx + budget], count
+   emit8(0x48); emit8(0x81); emit8(0xab); emit32(OFFBUDGET); emit32(count);
+
+   for (uint64_t idx = 0; idx < count; idx++)
+   {
+      uint64_t ipc = pcs[idx];
+      bool error = false;
+      uint8_t byte = mem->getByte(ipc, error);
+      uint64_t icode = byte >> 4;
+      uint64_t ifun = byte & 0xf;
+      const InstrProps & props = InstrTable::lookup(icode, ifun);
+      if (error || ipc + props.length > MEMSIZE)
+      {
+         emitStop(ipc, SADR, idx);
+         break;
+      }
+      if (!props.valid)
+      {
+         emitStop(ipc, SINS, idx);
+         break;
+      }
+
+      uint8_t regs = mem->getByte(ipc + 1, error);
+      uint64_t rA = props.needRegIds ? regs >> 4 : RNONE;
+      uint64_t rB = props.needRegIds ? regs & 0xf : RNONE;
+      uint64_t valC = 0;
+      for (int32_t i = 0; props.needValC && i < LONGSIZE; i++)
+         valC |= (uint64_t) mem->getByte(ipc + 1 + props.needRegIds + i,
+                                         error) << (8 * i);
+      uint64_t valP = ipc + props.length;
+
+      if (icode == IIADDQ || icode == ILEAVE || icode == IXCHGQ ||
+          (icode == IOPQ && ifun > XORQ))
+      {
+         //the extended instructions are rare enough to run in a helper
+         emitImm(HRSI, icode << 12 | ifun << 8 | rA << 4 | rB);
+         emitImm(HRDX, valC);
+         emitImm(HRCX, ipc);
+         emitCall((void *) extended);
+         emitCheckExit(idx);
+         if (icode == IXCHGQ) emitCheckFlush(valP, idx + 1);
+         icode = INOP;
+      }
+
+      switch (icode)
+      {
+         case IHALT:
+            emitStop(ipc, SHLT, idx + 1);
+            break;
+         case INOP:
+            break;
+         case IRRMOVQ:
+            if (rB == RNONE) break;
+            emitLoad(HRDX, OFFREG(rA));
+            if (ifun != UNCOND)
+            {
+               emitCond(ifun);
+               emitLoad(HRAX, OFFREG(rB));
+               //cmovae rdx, rax (keep rB if the condition fails)
+               emit8(0x48); emit8(0x0f); emit8(0x43); emit8(0xd0);
+            }
+            emitStore(HRDX, OFFREG(rB));
+            break;
+         case IIRMOVQ:
+            if (rB == RNONE) break;
+            emitImm(HRAX, valC);
+            emitStore(HRAX, OFFREG(rB));
+            break;
+         case IRMMOVQ:
+            emitLoad(HRSI, OFFREG(rB));
+            emitImm(HRAX, valC);
+            //add rsi, rax
+            emit8(0x48); emit8(0x01); emit8(0xc6);
+            emitLoad(HRDX, OFFREG(rA));
+            emitImm(HRCX, ipc);
+            emitCall((void *) store);
+            emitCheckExit(idx);
+            emitCheckFlush(valP, idx + 1);
+            break;
+         case IMRMOVQ:
+            emitLoad(HRSI, OFFREG(rB));
+            emitImm(HRAX, valC);
+            //add rsi, rax
+            emit8(0x48); emit8(0x01); emit8(0xc6);
+            emitImm(HRDX, ipc);
+            emitCall((void *) load);
+            emitCheckExit(idx);
+            if (rA != RNONE) emitStore(HRAX, OFFREG(rA));
+            break;
+         case IOPQ:
+            emitLoad(HRAX, OFFREG(rB));
+            emitLoad(HRCX, OFFREG(rA));
+            //add/sub/and/xor rax, rcx
+            emit8(0x48);
+            emit8(ifun == ADDQ ? 0x01 : ifun == SUBQ ? 0x29 :
+                  ifun == ANDQ ? 0x21 : 0x31);
+            emit8(0xc8);
+            //setz cl; sets dl
+            emit8(0x0f); emit8(0x94); emit8(0xc1);
+            emit8(0x0f); emit8(0x98); emit8(0xc2);
+            if (ifun == ADDQ || ifun == SUBQ)
+            {
+               //seto r8b; movzx r8d, r8b
+               emit8(0x41); emit8(0x0f); emit8(0x90); emit8(0xc0);
+               emit8(0x45); emit8(0x0f); emit8(0xb6); emit8(0xc0);
+               //shl r8d, 2
+               emit8(0x41); emit8(0xc1); emit8(0xe0); emit8(0x02);
+            }
+            else
+            {
+               //the logical operations leave OF unchanged:
+               //mov r8, [rbx + cc]; and r8d, 4
+               emitLoad(HR8, OFFCC);
+               emit8(0x41); emit8(0x83); emit8(0xe0); emit8(0x04);
+            }
+            //movzx ecx, cl; movzx edx, dl; lea ecx, [rcx + rdx * 2]
+            emit8(0x0f); emit8(0xb6); emit8(0xc9);
+            emit8(0x0f); emit8(0xb6); emit8(0xd2);
+            emit8(0x8d); emit8(0x0c); emit8(0x51);
+            //or ecx, r8d
+            emit8(0x44); emit8(0x09); emit8(0xc1);
+            emitStore(HRCX, OFFCC);
+            if (rB != RNONE) emitStore(HRAX, OFFREG(rB));
+            break;
+         case IJXX:
+            if (ifun != UNCOND)
+            {
+               emitCond(ifun);
+               uint8_t * notTaken = emitJcc(JAE);
+               emitExit(valC, idx + 1);
+               patch(notTaken, next);
+               emitExit(valP, idx + 1);
+            }
+            else
+            {
+               emitExit(valC, idx + 1);
+            }
+            break;
+         case ICALL:
+         case IPUSHQ:
+            emitLoad(HRSI, OFFREG(RSP));
+            //sub rsi, 8
+            emit8(0x48); emit8(0x83); emit8(0xee); emit8(0x08);
+            if (icode == ICALL) emitImm(HRDX, valP);
+            else emitLoad(HRDX, OFFREG(rA));
+            emitImm(HRCX, ipc);
+            emitCall((void *) store);
+            emitCheckExit(idx);
+            emitLoad(HRAX, OFFREG(RSP));
+            //sub rax, 8
+            emit8(0x48); emit8(0x83); emit8(0xe8); emit8(0x08);
+            emitStore(HRAX, OFFREG(RSP));
+            if (icode == ICALL)
+            {
+               emitCheckFlush(valC, idx + 1);
+               emitExit(valC, idx + 1);
+            }
+            else
+            {
+               emitCheckFlush(valP, idx + 1);
+            }
+            break;
+         case IPOPQ:
+         case IRET:
+            emitLoad(HRSI, OFFREG(RSP));
+            emitImm(HRDX, ipc);
+            emitCall((void *) load);
+            emitCheckExit(idx);
+            emitLoad(HRDX, OFFREG(RSP));
+            //add rdx, 8
+            emit8(0x48); emit8(0x83); emit8(0xc2); emit8(0x08);
+            emitStore(HRDX, OFFREG(RSP));
+            if (icode == IPOPQ)
+            {
+               if (rA != RNONE) emitStore(HRAX, OFFREG(rA));
+               break;
+            }
+            //the return address is only known at run time:
+            //mov [rbx + pc], rax; add qword [rbx + icount], idx + 1
+            emitStore(HRAX, OFFPC);
+            emit8(0x48); emit8(0x81); emit8(0x83); emit32(OFFICOUNT);
+            emit32(idx + 1);
+            //cmp rax, MEMSIZE; jae epilogue
+            emit8(0x48); emit8(0x3d); emit32(MEMSIZE);
+            patch(emitJcc(JAE), epilogue);
+            //mov rcx, blockAt; mov rcx, [rcx + rax * 8]
+            emitImm(HRCX, (uint64_t) blockAt);
+            emit8(0x48); emit8(0x8b); emit8(0x0c); emit8(0xc1);
+            //test rcx, rcx; je epilogue; jmp rcx
+            emit8(0x48); emit8(0x85); emit8(0xc9);
+            patch(emitJcc(JE), epilogue);
+            emit8(0xff); emit8(0xe1);
+            break;
+      }
+
+      //a block that ran out of room continues at the next instruction
+      if (idx == count - 1 && icode != IJXX && icode != ICALL &&
+          icode != IRET && icode != IHALT)
+         emitExit(valP, count);
+   }
+
+   //chain the exits that were waiting for this block
+   for (size_t i = 0; i < slots.size(); )
+   {
+      if (slots[i].target == pc)
+      {
+         patch(slots[i].jmp + 1, block);
+         slots[i] = slots.back();
+         slots.pop_back();
+      }
+      else
+      {
+         i++;
+      }
+   }
+   return block;
+}
+
+/*
+ * load
+ * called by the translated code to read a 64-bit word from Memory;
+ * on an address error the status is set to SADR and the block exits
+ *
+ * @param st - state of the translated program
+ * @param addr - address to read
+ * @param pc - address of the instruction doing the read
+ * @return the word at addr, or 0 on an error
+ */
+uint64_t Translator::load(TranslatorState * st, uint64_t addr, uint64_t pc)
+{
+   bool error = addr >= MEMSIZE;
+   uint64_t value = 0;
+   if (!error) value = Memory::getInstance()->getLong(addr, error);
+   if (error)
+   {
+      st->stat = SADR;
+      st->pc = pc;
+      st->exit = 1;
+   }
+   return value;
+}
+
+/*
+ * store
+ * called by the translated code to write a 64-bit word to Memory;
+ * on an address error the status is set to SADR and the block exits.
+ * A store into translated code flushes every translation and the
+ * block exits once the storing instruction completes.
+ *
+ * @param st - state of the translated program
+ * @param addr - address to write
+ * @param value - value to write
+ * @param pc - address of the instruction doing the write
+ */
+void Translator::store(TranslatorState * st, uint64_t addr, uint64_t value,
+                       uint64_t pc)
+{
+   bool error = addr >= MEMSIZE;
+   if (!error) Memory::getInstance()->putLong(value, addr, error);
+   if (error)
+   {
+      st->stat = SADR;
+      st->pc = pc;
+      st->exit = 1;
+      return;
+   }
+   bool code = false;
+   for (uint64_t i = 0; i < LONGSIZE; i++) code |= st->owner->codeMap[addr + i];
+   if (code)
+   {
+      st->owner->flush();
+      st->flushed = 1;
+   }
+}
+
+/*
+ * extended
+ * called by the translated code to execute an instruction of the
+ * extended ISA (iaddq, leave, xchgq, or an OPq beyond xorq); on an address
+ * error the status is set to SADR and the block exits
+ *
+ * @param st - state of the translated program
+ * @param instr - icode << 12 | ifun << 8 | rA << 4 | rB
+ * @param valC - constant of the instruction
+ * @param pc - address of the instruction
+ */
+void Translator::extended(TranslatorState * st, uint64_t instr, uint64_t valC,
+                          uint64_t pc)
+{
+   uint64_t icode = instr >> 12;
+   uint64_t rA = (instr >> 4) & 0xf;
+   uint64_t rB = instr & 0xf;
+   if (icode == ILEAVE)
+   {
+      uint64_t value = load(st, st->reg[RBP], pc);
+      if (st->exit) return;
+      st->reg[RSP] = st->reg[RBP] + 8;
+      st->reg[RBP] = value;
+      return;
+   }
+   if (icode == IXCHGQ)
+   {
+      uint64_t addr = st->reg[rB] + valC;
+      uint64_t value = load(st, addr, pc);
+      if (!st->exit) store(st, addr, st->reg[rA], pc);
+      if (!st->exit && rA != RNONE) st->reg[rA] = value;
+      return;
+   }
+
+   uint64_t alufun = icode == IIADDQ ? ADDQ : (instr >> 8) & 0xf;
+   uint64_t opA = icode == IIADDQ ? valC : st->reg[rA];
+   uint64_t opB = st->reg[rB];
+   uint64_t result = InstrTable::alu(opA, opB, alufun);
+   bool of = InstrTable::overflow(opA, opB, alufun, (st->cc >> 2) & 1);
+   st->cc = (result == 0) | Tools::sign(result) << 1 | of << 2;
+   if (rB != RNONE) st->reg[rB] = result;
+}
+
+/*
+ * link
+ * makes the jmp rel32 at jmp go to the translation of target, or to
+ * the epilogue until target is translated
+ */
+void Translator::link(uint8_t * jmp, uint64_t target)
+{
+   if (target < MEMSIZE && blockAt[target] != NULL)
+   {
+      patch(jmp + 1, blockAt[target]);
+      return;
+   }
+   patch(jmp + 1, epilogue);
+   if (target < MEMSIZE)
+   {
+      ChainSlot slot = {jmp, target};
+      slots.push_back(slot);
+   }
+}
+
+/*
+ * patch
+ * sets the rel32 operand at rel32 so that the jump goes to dest
+ */
+void Translator::patch(uint8_t * rel32, uint8_t * dest)
+{
+   int32_t offset = (int32_t) (dest - (rel32 + 4));
+   memcpy(rel32, &offset, 4);
+}
+
+void Translator::emit8(uint8_t byte)
+{
+   *next++ = byte;
+}
+
+void Translator::emit32(uint32_t word)
+{
+   memcpy(next, &word, 4);
+   next += 4;
+}
+
+void Translator::emit64(uint64_t word)
+{
+   memcpy(next, &word, 8);
+   next += 8;
+}
+
+/*
+ * emitLoad
+ * mov hostReg, [rbx + offset]
+ */
+void Translator::emitLoad(int32_t hostReg, int32_t offset)
+{
+   emit8(0x48 | (hostReg >= 8 ? 4 : 0));
+   emit8(0x8b);
+   emit8(0x83 | ((hostReg & 7) << 3));
+   emit32(offset);
+}
+
+/*
+ * emitStore
+ * mov [rbx + offset], hostReg
+ */
+void Translator::emitStore(int32_t hostReg, int32_t offset)
+{
+   emit8(0x48 | (hostReg >= 8 ? 4 : 0));
+   emit8(0x89);
+   emit8(0x83 | ((hostReg & 7) << 3));
+   emit32(offset);
+}
+
+/*
+ * emitImm
+ * mov hostReg, value
+ */
+void Translator::emitImm(int32_t hostReg, uint64_t value)
+{
+   emit8(0x48 | (hostReg >= 8 ? 1 : 0));
+   emit8(0xb8 + (hostReg & 7));
+   emit64(value);
+}
+
+/*
+ * emitCond
+ * sets the carry flag to the jXX/cmovXX condition ifun by testing
+ * the condition codes against the truth table from InstrTable:
+ * mov rcx, [rbx + cc]; mov eax, mask; bt eax, ecx
+ */
+void Translator::emitCond(uint64_t ifun)
+{
+   emitLoad(HRCX, OFFCC);
+   emit8(0xb8); emit32(InstrTable::condMask(ifun));
+   emit8(0x0f); emit8(0xa3); emit8(0xc8);
+}
+
+/*
+ * emitCall
+ * calls fn(state, rsi, rdx, rcx):
+ * mov rdi, rbx; mov rax, fn; call rax
+ */
+void Translator::emitCall(void * fn)
+{
+   emit8(0x48); emit8(0x89); emit8(0xdf);
+   emitImm(HRAX, (uint64_t) fn);
+   emit8(0xff); emit8(0xd0);
+}
+
+/*
+ * emitJcc
+ * emits a conditional jump with an unpatched rel32
+ *
+ * @param cc - second opcode byte (JB, JAE, ...)
+ * @return address of the rel32 operand
+ */
+uint8_t * Translator::emitJcc(uint8_t cc)
+{
+   emit8(0x0f);
+   emit8(cc);
+   uint8_t * rel32 = next;
+   emit32(0);
+   return rel32;
+}
+
+/*
+ * emitExit
+ * leaves the block for the instruction at target after count
+ * instructions of the block have executed; the jmp is chained to
+ * the translation of target
+ */
+void Translator::emitExit(uint64_t target, uint64_t count)
+{
+   //add qword [rbx + icount], count
+   emit8(0x48); emit8(0x81); emit8(0x83); emit32(OFFICOUNT); emit32(count);
+   emitImm(HRAX, target);
+   emitStore(HRAX, OFFPC);
+   uint8_t * jmp = next;
+   emit8(0xe9);
+   emit32(0);
+   link(jmp, target);
+}
+
+/*
+ * emitStop
+ * leaves the block with status stat at the instruction at pc
+ */
+void Translator::emitStop(uint64_t pc, uint64_t stat, uint64_t count)
+{
+   //add qword [rbx + icount], count
+   emit8(0x48); emit8(0x81); emit8(0x83); emit32(OFFICOUNT); emit32(count);
+   //mov qword [rbx + stat], stat; mov qword [rbx + pc], pc
+   emit8(0x48); emit8(0xc7); emit8(0x83); emit32(OFFSTAT); emit32(stat);
+   emitImm(HRAX, pc);
+   emitStore(HRAX, OFFPC);
+   emit8(0xe9);
+   emit32(0);
+   patch(next - 4, epilogue);
+}
+
+/*
+ * emitCheckExit
+ * leaves the block if a memory helper reported an address error;
+ * count is the number of instructions of the block that completed
+ */
+void Translator::emitCheckExit(uint64_t count)
+{
+   //cmp qword [rbx + exit], 0; je over
+   emit8(0x48); emit8(0x83); emit8(0xbb); emit32(OFFEXIT); emit8(0);
+   emit8(0x74);
+   uint8_t * over = next;
+   emit8(0);
+   //add qword [rbx + icount], count; jmp epilogue
+   emit8(0x48); emit8(0x81); emit8(0x83); emit32(OFFICOUNT); emit32(count);
+   emit8(0xe9);
+   emit32(0);
+   patch(next - 4, epilogue);
+   *over = (uint8_t) (next - (over + 1));
+}
+
+/*
+ * emitCheckFlush
+ * leaves the block for the instruction at target if the last store
+ * overwrote translated code
+ */
+void Translator::emitCheckFlush(uint64_t target, uint64_t count)
+{
+   //cmp qword [rbx + flushed], 0; je over
+   emit8(0x48); emit8(0x83); emit8(0xbb); emit32(OFFFLUSHED); emit8(0);
+   emit8(0x74);
+   uint8_t * over = next;
+   emit8(0);
+   //add qword [rbx + icount], count
+   emit8(0x48); emit8(0x81); emit8(0x83); emit32(OFFICOUNT); emit32(count);
+   emitImm(HRAX, target);
+   emitStore(HRAX, OFFPC);
+   emit8(0xe9);
+   emit32(0);
+   patch(next - 4, epilogue);
+   *over = (uint8_t) (next - (over + 1));
+}
+
+/*
+ * getInstructions
+ * @return number of Y86-64 instructions executed
+ */
+uint64_t Translator::getInstructions()
+{
+   return state.icount;
+}
+
+/*
+ * getStat
+ * @return final status (SHLT, SADR or SINS)
+ */
+uint64_t Translator::getStat()
+{
+   return state.stat;
+}
+
+/*
+ * getBlocks
+ * @return number of basic blocks translated
+ */
+uint64_t Translator::getBlocks()
+{
+   return numBlocks;
+}
+
+/*
+ * getFlushes
+ * @return number of times the translations were discarded because
+ *         of a store into code
+ */
+uint64_t Translator::getFlushes()
+{
+   return numFlushes;
+}
+
+/*
+ * dump
+ * outputs the statistics of the run followed by the condition codes,
+ * register file and memory
+ */
+void Translator::dump()
+{
+   if (code == NULL)
+   {
+      std::cout << "Translation is not supported on this host." << std::endl;
+   }
+   std::cout << "\nAt end of translated run:" << std::endl;
+   std::cout << "stat: " << std::hex << state.stat << " pc: "
+             << std::setw(3) << std::setfill('0') << state.pc
+             << std::dec << " instructions: " << state.icount
+             << " blocks: " << numBlocks << " flushes: " << numFlushes
+             << std::endl;
+   ConditionCodes::getInstance()->dump();
+   RegisterFile::getInstance()->dump();
+   Memory::getInstance()->dump();
+}
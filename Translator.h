@@ -0,0 +1,85 @@
+#include <cstdint>
+#include <vector>
+#include "Memory.h"
+#ifndef TRANSLATOR_H
+#define TRANSLATOR_H
+
+//size of the buffer that holds the translated x86-64 code
+#define CODESIZE 0x400000
+//maximum number of Y86-64 instructions in one basic block
+#define MAXBLOCKINSTRS 64
+//number of instructions executed before control returns to run
+#define QUANTUM 0x100000
+
+class Translator;
+
+//architectural state of the translated program; the translated
+//code addresses it through rbx
+struct TranslatorState
+{
+   uint64_t pc;         //address of the next instruction
+   uint64_t cc;         //ZF | SF << 1 | OF << 2 (layout of InstrTable::cond)
+   uint64_t stat;       //SAOK, SADR, SINS or SHLT
+   int64_t budget;      //instructions left before returning to run
+   uint64_t icount;     //number of instructions executed
+   uint64_t exit;       //set by the memory helpers on an address error
+   uint64_t flushed;    //set when a store overwrote translated code
+   Translator * owner;  //translator to flush on a store into code
+   uint64_t reg[16];    //register file; reg[RNONE] always reads 0
+};
+
+//a jmp rel32 at the end of a block that is waiting for the
+//block at target to be translated
+struct ChainSlot
+{
+   uint8_t * jmp;
+   uint64_t target;
+};
+
+//dynamic binary translator that turns the Y86-64 basic blocks in
+//Memory into x86-64 code and runs them
+class Translator
+{
+   private:
+      TranslatorState state;
+      uint8_t * code;            //start of the code buffer
+      uint8_t * next;            //next free byte in the code buffer
+      uint8_t * epilogue;        //returns from the translated code to run
+      uint8_t * blockAt[MEMSIZE];  //translation of the block at each address
+      uint8_t codeMap[MEMSIZE];  //1 if the byte was translated
+      std::vector<ChainSlot> slots;
+      uint64_t numBlocks;
+      uint64_t numFlushes;
+      void flush();
+      uint8_t * translate(uint64_t pc);
+      void link(uint8_t * jmp, uint64_t target);
+      void emit8(uint8_t byte);
+      void emit32(uint32_t word);
+      void emit64(uint64_t word);
+      void emitLoad(int32_t hostReg, int32_t offset);
+      void emitStore(int32_t hostReg, int32_t offset);
+      void emitImm(int32_t hostReg, uint64_t value);
+      void emitCond(uint64_t ifun);
+      void emitCall(void * fn);
+      uint8_t * emitJcc(uint8_t cc);
+      void emitExit(uint64_t target, uint64_t count);
+      void emitStop(uint64_t pc, uint64_t stat, uint64_t count);
+      void emitCheckExit(uint64_t count);
+      void emitCheckFlush(uint64_t target, uint64_t count);
+      void patch(uint8_t * rel32, uint8_t * dest);
+      static uint64_t load(TranslatorState * st, uint64_t addr, uint64_t pc);
+      static void store(TranslatorState * st, uint64_t addr, uint64_t value,
+                        uint64_t pc);
+      static void extended(TranslatorState * st, uint64_t instr, uint64_t valC,
+                           uint64_t pc);
+   public:
+      Translator();
+      ~Translator();
+      void run();
+      uint64_t getInstructions();
+      uint64_t getStat();
+      uint64_t getBlocks();
+      uint64_t getFlushes();
+      void dump();
+};
+#endif
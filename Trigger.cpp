@@ -0,0 +1,260 @@
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "Memory.h"
+#include "RegisterFile.h"
+#include "ConditionCodes.h"
+#include "Instructions.h"
+#include "InstrTable.h"
+#include "PipeReg.h"
+#include "Machine.h"
+#include "Snapshots.h"
+#include "Trigger.h"
+
+//triggerInstance will be initialized to the single Trigger object
+Trigger * Trigger::triggerInstance = NULL;
+
+/*
+ * Trigger constructor
+ * starts with no breakpoints, watchpoints or conditions
+ */
+Trigger::Trigger()
+{
+   for (int32_t i = 0; i < MEMSIZE; i++) breakpoint[i] = false;
+   for (int32_t i = 0; i < REGSIZE; i++) regWatch[i] = false;
+   set = false;
+   running = false;
+}
+
+/*
+ * getInstance
+ * if triggerInstance is NULL then creates a Trigger object
+ * and sets triggerInstance to point to it; returns triggerInstance
+ *
+ * @return triggerInstance
+ */
+Trigger * Trigger::getInstance()
+{
+   if (triggerInstance == NULL)
+   {
+      triggerInstance = new Trigger();
+   }
+   return triggerInstance;
+}
+
+/*
+ * addBreakpoint
+ * fires in the cycle that fetches the instruction at pc
+ */
+void Trigger::addBreakpoint(uint64_t pc)
+{
+   if (pc < MEMSIZE) breakpoint[pc] = true;
+   set = true;
+}
+
+/*
+ * addMemoryWatch
+ * fires in a cycle that writes any of the length bytes at address
+ */
+void Trigger::addMemoryWatch(int32_t address, int32_t length)
+{
+   MemoryWatch watch = {address, address + length - 1};
+   memWatches.push_back(watch);
+   Memory::getInstance()->addObserver(this);
+   set = true;
+}
+
+/*
+ * addRegisterWatch
+ * fires in a cycle that writes register regNumber
+ */
+void Trigger::addRegisterWatch(int32_t regNumber)
+{
+   if (regNumber >= 0 && regNumber < REGSIZE) regWatch[regNumber] = true;
+   RegisterFile::getInstance()->setWatched(true);
+   set = true;
+}
+
+/*
+ * addCondition
+ * fires in a cycle at the end of which the jXX/cmovXX condition ifun
+ * holds for the condition codes and did not hold a cycle earlier
+ *
+ * @param ifun - condition (UNCOND, LESSEQ, ...)
+ */
+void Trigger::addCondition(uint64_t ifun)
+{
+   conditions.push_back(ifun);
+   held.push_back(false);
+   set = true;
+}
+
+/*
+ * isSet
+ * @return true if any trigger was added
+ */
+bool Trigger::isSet()
+{
+   return set;
+}
+
+/*
+ * memoryWritten
+ * called by the Memory when length bytes at address are written
+ * once a memory watch has been added
+ */
+void Trigger::memoryWritten(int32_t address, int32_t length)
+{
+   if (!running) return;
+   for (uint64_t i = 0; i < memWatches.size(); i++)
+   {
+      if (address <= memWatches[i].high &&
+          address + length - 1 >= memWatches[i].low)
+      {
+         std::ostringstream reason;
+         reason << "memory write: " << std::hex << std::setw(3)
+                << std::setfill('0') << address;
+         reasons.push_back(reason.str());
+         return;
+      }
+   }
+}
+
+/*
+ * registerWritten
+ * called by the RegisterFile when register regNumber is written
+ * while it is watched
+ */
+void Trigger::registerWritten(int32_t regNumber)
+{
+   if (running && regNumber >= 0 && regNumber < REGSIZE && regWatch[regNumber])
+   {
+      std::ostringstream reason;
+      reason << "register write: " << std::hex << regNumber;
+      reasons.push_back(reason.str());
+   }
+}
+
+/*
+ * conditionName
+ * @return suffix of the jXX instruction with condition ifun
+ *         ("le", "l", ...), or "mp" for UNCOND
+ */
+const char * Trigger::conditionName(uint64_t ifun)
+{
+   static const char * names[] = {"mp", "le", "l", "e", "ne", "ge", "g"};
+   return ifun <= GREATER ? names[ifun] : "?";
+}
+
+/*
+ * checkConditions
+ * evaluates the condition triggers with the current condition codes
+ *
+ * @return true if a condition became true
+ */
+bool Trigger::checkConditions()
+{
+   bool error = false;
+   ConditionCodes * cc = ConditionCodes::getInstance();
+   bool zf = cc->getConditionCode(ZF, error);
+   bool sf = cc->getConditionCode(SF, error);
+   bool of = cc->getConditionCode(OF, error);
+   bool fired = false;
+
+   for (uint64_t i = 0; i < conditions.size(); i++)
+   {
+      bool holds = InstrTable::cond(conditions[i], zf, sf, of);
+      if (holds && !held[i])
+      {
+         std::ostringstream reason;
+         reason << "condition: " << conditionName(conditions[i]);
+         reasons.push_back(reason.str());
+         fired = true;
+      }
+      held[i] = holds;
+   }
+   return fired;
+}
+
+/*
+ * flush
+ * outputs and discards the kept snapshots of the cycles before a
+ * trigger fired, oldest first
+ *
+ * @param history - ring of snapshots; the next one is taken at next
+ * @param kept - number of snapshots in the ring, set to 0
+ */
+void Trigger::flush(Snapshots & snapshots, std::vector<Snapshot> & history,
+                    uint64_t next, uint64_t & kept)
+{
+   for (uint64_t i = kept; i > 0; i--)
+      snapshots.format(history[(next + history.size() - i) % history.size()],
+                       std::cout);
+   kept = 0;
+}
+
+/*
+ * run
+ * simulates the machine until it halts, dumping the state only in the
+ * cycles in which a trigger fires and in the window cycles before and
+ * after each of them. Each firing is announced by a line listing the
+ * triggers that fired, followed by the dump of that cycle. The state of
+ * the window cycles before a firing is copied into a ring each cycle
+ * and only formatted if a trigger fires.
+ *
+ * @param machine - loaded machine to run
+ * @param window - number of cycles dumped before and after a firing
+ */
+void Trigger::run(Machine & machine, uint64_t window)
+{
+   Snapshots snapshots(&machine);
+   std::vector<Snapshot> history(window);   //state of the last window cycles
+   uint64_t next = 0;                       //slot of the next snapshot
+   uint64_t kept = 0;                       //snapshots in the ring
+   uint64_t after = 0;                      //cycles left to dump after a firing
+
+   checkConditions();
+   reasons.clear();
+   running = true;
+   while (!machine.isHalted())
+   {
+      uint64_t pc = machine.getFetchPC();
+      if (pc < MEMSIZE && breakpoint[pc])
+      {
+         std::ostringstream reason;
+         reason << "breakpoint: " << std::hex << std::setw(3)
+                << std::setfill('0') << pc;
+         reasons.push_back(reason.str());
+      }
+      machine.step(1);
+      checkConditions();
+
+      if (reasons.size() > 0)
+      {
+         flush(snapshots, history, next, kept);
+         std::cout << "\nTriggered:";
+         for (uint64_t i = 0; i < reasons.size(); i++)
+            std::cout << " " << reasons[i] << (i + 1 < reasons.size() ? "," : "");
+         std::cout << std::endl;
+         machine.dump();
+         reasons.clear();
+         after = window;
+      }
+      else if (after > 0)
+      {
+         machine.dump();
+         after--;
+      }
+      else if (window > 0)
+      {
+         //keep the state so it can be output if a trigger fires
+         snapshots.take(history[next]);
+         next = (next + 1) % window;
+         if (kept < window) kept++;
+      }
+   }
+   running = false;
+}
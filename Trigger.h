@@ -0,0 +1,51 @@
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Memory.h"
+#ifndef TRIGGER_H
+#define TRIGGER_H
+
+class Machine;
+class Snapshots;
+struct Snapshot;
+
+//a range of memory addresses [low, high] that is being watched
+struct MemoryWatch
+{
+   int32_t low;
+   int32_t high;
+};
+
+//breakpoints, watchpoints and condition triggers that decide which
+//cycles are dumped. The Memory reports writes to the Trigger once it
+//is an observer and the RegisterFile after setWatched(true), so
+//nothing is checked when no trigger is set.
+class Trigger : public MemoryObserver
+{
+   private:
+      static Trigger * triggerInstance;
+      Trigger();
+      bool breakpoint[MEMSIZE];            //true if fetching the address fires
+      std::vector<MemoryWatch> memWatches;
+      bool regWatch[REGSIZE];              //true if writing the register fires
+      std::vector<uint64_t> conditions;    //jXX/cmovXX conditions (ifun)
+      std::vector<bool> held;              //value of each condition last cycle
+      bool set;                            //true if any trigger was added
+      bool running;                        //true while run is simulating
+      std::vector<std::string> reasons;    //triggers that fired this cycle
+      bool checkConditions();
+      void flush(Snapshots & snapshots, std::vector<Snapshot> & history,
+                 uint64_t next, uint64_t & kept);
+   public:
+      static Trigger * getInstance();
+      void addBreakpoint(uint64_t pc);
+      void addMemoryWatch(int32_t address, int32_t length);
+      void addRegisterWatch(int32_t regNumber);
+      void addCondition(uint64_t ifun);
+      bool isSet();
+      static const char * conditionName(uint64_t ifun);
+      void memoryWritten(int32_t address, int32_t length);
+      void registerWritten(int32_t regNumber);
+      void run(Machine & machine, uint64_t window);
+};
+#endif
@@ -22,6 +22,23 @@ W::W()
    valM = new PipeRegField();
    dstE = new PipeRegField(RNONE);
    dstM = new PipeRegField(RNONE);
+   pc = new PipeRegField(NOPC);
+}
+
+/*
+ * W destructor
+ *
+ * frees the fields of the W pipeline register
+ */
+W::~W()
+{
+   delete stat;
+   delete icode;
+   delete valE;
+   delete valM;
+   delete dstE;
+   delete dstM;
+   delete pc;
 }
 
 /* return the stat pipeline register field */
@@ -60,18 +77,39 @@ PipeRegField * W::getdstM()
    return dstM;
 }
 
+/* return the pc pipeline register field */
+PipeRegField * W::getpc()
+{
+   return pc;
+}
+
 /* 
  * dump
  *
- * outputs the current values of the W pipeline register
+ * outputs the current values of the W pipeline register to out
 */
-void W:: dump()
+void W::dump(std::ostream & out)
 {
-   dumpField("W: stat: ", 1, stat->getOutput(), false);
-   dumpField(" icode: ", 1, icode->getOutput(), false);
-   dumpField(" valE: ", 16, valE->getOutput(), false);
-   dumpField(" valM: ", 16, valM->getOutput(), false);
-   dumpField(" dstE: ", 1, dstE->getOutput(), false);
-   dumpField(" dstM: ", 1, dstM->getOutput(), true);
+   dumpField(out, "W: stat: ", 1, stat->getOutput(), false);
+   dumpField(out, " icode: ", 1, icode->getOutput(), false);
+   dumpField(out, " valE: ", 16, valE->getOutput(), false);
+   dumpField(out, " valM: ", 16, valM->getOutput(), false);
+   dumpField(out, " dstE: ", 1, dstE->getOutput(), false);
+   dumpField(out, " dstM: ", 1, dstM->getOutput(), true);
 }
 
+/*
+ * reset
+ *
+ * returns the W pipeline register to the values set by the constructor
+*/
+void W::reset()
+{
+   stat->bubble(SAOK);
+   icode->bubble(INOP);
+   valE->bubble();
+   valM->bubble();
+   dstE->bubble(RNONE);
+   dstM->bubble(RNONE);
+   pc->bubble(NOPC);
+}
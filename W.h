@@ -8,13 +8,17 @@ class W : public PipeReg
       PipeRegField * valM;
       PipeRegField * dstE;
       PipeRegField * dstM;
+      PipeRegField * pc;    //address of the instruction; not dumped
    public:
       W();
+      ~W();
       PipeRegField * getstat();
       PipeRegField * geticode();
       PipeRegField * getvalE();
       PipeRegField * getvalM();
       PipeRegField * getdstE();
       PipeRegField * getdstM();
-      void dump();
+      PipeRegField * getpc();
+      void dump(std::ostream & out);
+      void reset();
 };
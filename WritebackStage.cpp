@@ -1,3 +1,4 @@
+#include <iostream>
 #include <string>
 #include <cstdint>
 #include "RegisterFile.h"
@@ -13,6 +14,9 @@
 #include "Status.h"
 #include "Debug.h"
 #include "Instructions.h"
+#include "Memory.h"
+#include "ReplayLog.h"
+#include "Energy.h"
 
 
 /*
@@ -56,5 +60,17 @@ void WritebackStage::doClockHigh(PipeReg ** pregs)
    bool error;
 
    RegisterFile::getInstance()->writeRegister(W_valE, W_dstE, error);
+   if (W_dstE != RNONE)
+      TRACE(TRACEWRITEBACK, std::cout << "writeback: register " << std::hex
+            << W_dstE << " valE " << W_valE << std::endl);
    RegisterFile::getInstance()->writeRegister(W_valM, W_dstM, error);
+   if (W_dstM != RNONE)
+      TRACE(TRACEWRITEBACK, std::cout << "writeback: register " << std::hex
+            << W_dstM << " valM " << W_valM << std::endl);
+   if (Energy::isEnabled())
+   {
+      uint64_t pc = wreg->getpc()->getOutput();
+      if (W_dstE != RNONE) Energy::getInstance()->add(ENREGWRITE, pc);
+      if (W_dstM != RNONE) Energy::getInstance()->add(ENREGWRITE, pc);
+   }
 }
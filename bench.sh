@@ -0,0 +1,40 @@
+#!/bin/bash
+# Measures the host time per simulated cycle of the pipeline at each
+# revision given (default HEAD), e.g.
+#    ./bench.sh e67ec96^ e67ec96
+# Each revision is built with g++ -O2 together with yessbench.cpp from
+# the working tree and runs a straight-line program of 1200 ALU
+# instructions (about 1207 cycles) 1000 times, three times over.
+
+revisions=("$@")
+if [ ${#revisions[@]} -eq 0 ]; then revisions=(HEAD); fi
+top=$(git rev-parse --show-toplevel) || exit 1
+work=$(mktemp -d)
+trap 'rm -rf "$work"' EXIT
+
+#irmovq $1, %rax; irmovq $2, %rbx; 300 x (addq, subq, rrmovq, xorq); halt
+{
+   echo "0x000: 30f00100000000000000 |     irmovq \$1, %rax"
+   echo "0x00a: 30f30200000000000000 |     irmovq \$2, %rbx"
+   address=20
+   for ((i = 0; i < 300; i++)); do
+      for code in "6003 addq %rax, %rbx" "6131 subq %rbx, %rcx" \
+                  "2032 rrmovq %rbx, %rdx" "6326 xorq %rdx, %rsi"; do
+         printf "0x%03x: %-20s |     %s\n" $address ${code%% *} "${code#* }"
+         address=$((address + 2))
+      done
+   done
+   printf "0x%03x: %-20s |     halt\n" $address 00
+} > "$work/bench.yo"
+
+for revision in "${revisions[@]}"; do
+   src="$work/src"
+   rm -rf "$src" && mkdir "$src"
+   git -C "$top" archive "$revision" | tar -x -C "$src" || exit 1
+   cp "$top/yessbench.cpp" "$src/"
+   (cd "$src" && g++ -std=c++11 -O2 -pthread -I. -DTRACECOMPILED=0 \
+       -o "$work/yessbench" yessbench.cpp $(ls *.cpp | grep -v '^yess')) || exit 1
+   for run in 1 2 3; do
+      echo "$revision: $("$work/yessbench" "$work/bench.yo")"
+   done
+done
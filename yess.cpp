@@ -1,43 +1,712 @@
 /* 
  * Driver for the yess simulator
- * Usage: yess <file>.yo [-D]
+ * Usage: yess <file>.yo [-X] [-D | -T categories] [-J | -I | -S [period,warmup,window]
+ *                       | -O [fetch,issue,commit,rob,iq,lsq,regs]
+ *                       | -U cores[,threads[,quantum]] | -V lanes
+ *                       | -E fetch,execute,memory ...
+ *                       | -b [interval[,phases]]]
+ *                       [-F [paths]] [-H] [-Y [window]] [-G [folded]] [-W [table]]
+ *                       [-B pc] [-M address[,length]] [-R register]
+ *                       [-C condition] [-N cycles] [-L log [-K interval]]
+ *                       [-Z prints] [-Q trace]
+ *                       [-j json|csv [-f fields] [-y first[,last[,step]]]]
+ *        yess <file>.yo -A file.yo[,file.yo...]
+ *        yess <trace> -Q -E fetch,execute,memory ...
+ *        yess <log> -P first[,last]
  *
  * <file>.yo contains assembled y86-64 code.
- * If the -D option is provided then debug is set to 1.
- * The -D option can be used to turn on and turn off debugging print
- * statements.
+ * If the -X option is provided then the extended ISA (iaddq, leave,
+ * the atomic exchange xchgq rA, D(rB), and the mulq, divq, modq, salq,
+ * sarq and shrq OPq functions) is
+ * accepted by every engine; otherwise those are invalid instructions.
+ * If the -D option is provided then every trace category that was
+ * compiled in (cmake -DYESS_TRACE=mask) is output; -T selects a comma
+ * separated list of categories (fetch, decode, forward, execute, memory,
+ * writeback, loader). The number of events of each compiled category
+ * is output at the end of the run if tracing was enabled.
+ * If the -J option is provided then the program is run by translating
+ * it to x86-64 code instead of simulating the pipeline, and only the
+ * final state is output.
+ * If the -I option is provided then the program is run by the threaded
+ * interpreter; the final state is output along with the interpreter's
+ * dispatch rate and the cycle rate of the pipeline on the same program.
+ * If the -S option is provided then the program is run by the
+ * interpreter and every period instructions the pipeline measures the
+ * CPI of window instructions after warmup instructions; the final
+ * state is output along with the estimated number of cycles.
+ * If the -O option is provided then the program is run by the
+ * out-of-order core model with the given widths, reorder buffer,
+ * issue queue and load/store queue sizes and number of physical
+ * registers; the final state is output along with the IPC, reorder
+ * buffer occupancy and dispatch stalls of the core and the IPC of the
+ * pipeline on the same program.
+ * If the -U option is provided then cores pipelines, each with its own
+ * registers and condition codes and with its core number in %rdi,
+ * run the program from address 0 against one shared memory (use -X
+ * for the xchgq atomic). The cores are simulated on threads host
+ * threads (default 1, which is deterministic) that synchronise every
+ * quantum cycles (default 1000); the final state of every core is
+ * output along with the IPC of each core and of the whole run.
+ * If the -V option is provided then lanes copies of the machine, lane
+ * i starting with i in %rdi, run the program in a batch: the lanes at
+ * the same address execute each instruction together, so the work is
+ * shared while they agree. The aggregate instructions per second, the
+ * share of the steps that every running lane executed, the status of
+ * each lane and the final state of lane 0 are output.
+ * If the -E option is provided then the program is run by a model of
+ * the pipeline with its fetch, execute and memory stages split into
+ * the given numbers of sub-stages (1 to 8 each), which moves the
+ * forwarding, branch resolution and ret points back accordingly. The
+ * option can be repeated to time several configurations with one run
+ * of the program; the instructions, cycles, CPI and the penalties of
+ * mispredicted jXX, ret, taken jumps and load-use and alu-use
+ * dependences of each configuration and the final state are output.
+ * If the -b option is provided then the program is executed in
+ * intervals of interval instructions (default 1000) and the basic
+ * blocks executed in each interval are clustered into at most phases
+ * (default 10) phases of similar intervals. The pipeline then runs
+ * only the interval nearest the centre of each phase; each phase with
+ * its share of the instructions, representative interval and CPI, the
+ * phase of each interval, the CPI of the program estimated from the
+ * representative intervals and the final state are output.
+ * If the -Q option is provided with a file name then nothing is
+ * output; instead the program is executed once and the trace of its
+ * instructions (addresses, registers read and written, memory
+ * addresses and branch outcomes) is written to the file trace. With
+ * -Q and no file name, yess reads such a trace instead of a .yo file
+ * and times it with each -E configuration without executing the
+ * program; only the timing of each configuration is output.
+ * If the -j option is provided then the state at the end of each cycle
+ * is output as a JSON object per line or, with csv, as comma separated
+ * values after a line of column names, instead of the dumps. JSON
+ * values are strings of hex digits ("0x1f") so that 64-bit values are
+ * not rounded; CSV values are unsigned decimal numbers. -f
+ * selects a comma separated list of values: pipeline register fields
+ * (D.icode), whole pipeline registers (D), registers (rax) or regs,
+ * condition codes (ZF) or cc, memory words (0x018) and, in JSON, mem
+ * for every nonzero word. -y outputs only cycle first or cycles first
+ * through last every step cycles (default 1).
+ * If the -F option is provided then the forwarding paths in the comma
+ * separated list paths (e_valE, m_valM, M_valE, W_valM, W_valE or all)
+ * are disabled, so that an operand that needs one of them stalls
+ * decode, and the number of operands supplied by each path and by the
+ * register file is output at the end of the run.
+ * If the -H option is provided then the host time spent in the
+ * doClockLow and doClockHigh of each stage and in each dump of a
+ * pipeline run (the default run or a -B, -M, -R, -C run) is measured
+ * and output at the end as nanoseconds per simulated cycle.
+ * If the -Y option is provided then the addresses fetched and the
+ * words read and written by a pipeline run are recorded, and the
+ * reuse distance histograms of the fetches and of the data accesses,
+ * the number of lines touched in each window of cycles (default 100),
+ * the most frequent stride of each instruction that accesses memory
+ * and the accesses to each 32 byte line are output at the end.
+ * If the -G option is provided then each cycle of a pipeline run is
+ * charged to the call path of the instruction in the W register, and
+ * the calls and the inclusive and exclusive cycles of each function,
+ * named by the label at its address in the .yo file if it has one, are
+ * output at the end; the cycles of each call path are also written to
+ * the file folded in the folded stack format of flame graph tools.
+ * If the -W option is provided then the register file reads and
+ * writes, forwarded operands, ALU operations, condition code updates,
+ * memory accesses, fetches and pipeline register bits toggled by a
+ * pipeline run are counted, and the energy of each kind of event, the
+ * total energy, the average power and the energy of each instruction
+ * address are output at the end. The energy per event and the clock
+ * frequency can be changed by the file table, which holds lines such
+ * as "memread 12.5" (pJ) and "mhz 500".
+ * The -B (fetch of the instruction at pc), -M (write to memory),
+ * -R (write to a register) and -C (jXX condition such as le or ne
+ * becoming true) options can be repeated; pc, address, length and
+ * register are hex. If any of them is provided then the state is
+ * dumped only in the cycles in which one fires and in the -N cycles
+ * (default 0) before and after each of those.
+ * If the -L option is provided then nothing is output; instead the
+ * changes made by each cycle are written to the file log, with the
+ * whole state every -K cycles (default 1024). With -P, yess reads such
+ * a log instead of a .yo file and outputs the dumps of cycles first
+ * through last (counting down if last < first) without simulating.
+ * If the -Z option is provided then nothing is output; instead a hash
+ * of each pipeline register, the register file, the condition codes
+ * and the memory at the end of each cycle is written to the file
+ * prints. yesscmp compares two such files and outputs the first cycle
+ * in which the runs differ and the parts of the state that differ.
+ * With -A, <file>.yo and then each .yo file in the list are run by the
+ * pipeline one after the other on the same machine, which is reset
+ * between them, and the final state of each is output.
 */
 
 #include <iostream>
 #include <fstream>
+#include <string>
 #include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <vector>
 #include "Debug.h"
+#include "Instructions.h"
+#include "InstrTable.h"
 #include "Memory.h"
-#include "Loader.h"
 #include "RegisterFile.h"
 #include "ConditionCodes.h"
 #include "PipeReg.h"
 #include "Stage.h"
 #include "Simulate.h"
+#include "Translator.h"
+#include "Interpreter.h"
+#include "MachineState.h"
+#include "Sampler.h"
+#include "PhaseProfile.h"
+#include "OutOfOrder.h"
+#include "Forwarding.h"
+#include "Multicore.h"
+#include "Batch.h"
+#include "InstrTrace.h"
+#include "DeepPipe.h"
+#include "Machine.h"
+#include "Trigger.h"
+#include "ReplayLog.h"
+#include "OutputWriter.h"
+#include "Profiler.h"
+#include "AccessProfile.h"
+#include "CallProfile.h"
+#include "Energy.h"
+#include "Fingerprint.h"
+#include "StateExport.h"
 
-int debug = 0;
+/*
+ * dumpCalls
+ * outputs the call profile of the run and writes its folded stacks
+ * to the file foldedName unless it is NULL
+ */
+static void dumpCalls(const char * foldedName)
+{
+   CallProfile * profile = CallProfile::getInstance();
+   profile->dump();
+   if (foldedName != NULL && !profile->writeFolded(foldedName))
+      std::cout << "Unable to write " << foldedName << std::endl;
+}
 
 int main(int argc, char * argv[])
 {
-   //check to see if the -D option was provided 
-   if (argc >= 3 && (strcmp(argv[2], "-D") == 0)) debug = 1;
+   bool translate = false;
+   bool interpret = false;
+   bool sample = false;
+   bool outOfOrder = false;
+   unsigned long long numCores = 0, threads = 1, quantum = COREQUANTUM;
+   unsigned long long lanes = 0;
+   std::vector<DeepConfig> depths;
+   OoOConfig config = {OOOFETCHWIDTH, OOOISSUEWIDTH, OOOCOMMITWIDTH,
+                       OOOROBSIZE, OOOIQSIZE, OOOLSQSIZE, OOOPHYSREGS};
+   bool trace = false;
+   bool badCategories = false;
+   bool badPaths = false;
+   bool badTrigger = false;
+   bool forwarding = false;
+   bool profile = false;
+   bool accesses = false;
+   unsigned long long accessWindow = ACCESSWINDOW;
+   bool calls = false;
+   const char * foldedName = NULL;
+   bool energy = false;
+   const char * energyTable = NULL;
+   unsigned long long period = SAMPLEPERIOD;
+   unsigned long long warmup = SAMPLEWARMUP;
+   unsigned long long window = SAMPLEWINDOW;
+   uint64_t triggerWindow = 0;
+   const char * logName = NULL;
+   const char * printsName = NULL;
+   bool phased = false;
+   unsigned long long phaseInterval = PHASEINTERVAL, maxPhases = PHASEMAX;
+   bool traced = false;
+   const char * traceName = NULL;
+   const char * exportFormat = NULL;
+   const char * exportFields = NULL;
+   unsigned long long exportFirst = 0, exportLast = UINT64_MAX, exportStep = 1;
+   uint64_t interval = KEYINTERVAL;
+   const char * replayCycles = NULL;
+   const char * batch = NULL;
+   Trigger * trigger = Trigger::getInstance();
+
+   //check to see if the -D, -J, -I or -S options were provided 
+   for (int i = 2; i < argc; i++)
+   {
+      if (strcmp(argv[i], "-D") == 0)
+      {
+         Debug::setMask((1 << NUMTRACE) - 1);
+         trace = true;
+      }
+      if (i + 1 < argc && strcmp(argv[i], "-T") == 0)
+      {
+         uint32_t mask = 0;
+         if (Debug::parseMask(argv[++i], mask)) Debug::setMask(mask);
+         else badCategories = true;
+         trace = true;
+      }
+      if (strcmp(argv[i], "-X") == 0) InstrTable::setExtended(true);
+      if (strcmp(argv[i], "-J") == 0) translate = true;
+      if (strcmp(argv[i], "-I") == 0) interpret = true;
+      if (strcmp(argv[i], "-S") == 0)
+      {
+         sample = true;
+         if (i + 1 < argc && sscanf(argv[i + 1], "%llu,%llu,%llu",
+                                    &period, &warmup, &window) == 3) i++;
+      }
+      if (strcmp(argv[i], "-O") == 0)
+      {
+         unsigned long long v[7];
+         outOfOrder = true;
+         if (i + 1 < argc && sscanf(argv[i + 1],
+             "%llu,%llu,%llu,%llu,%llu,%llu,%llu", &v[0], &v[1], &v[2],
+             &v[3], &v[4], &v[5], &v[6]) == 7)
+         {
+            config = {v[0], v[1], v[2], v[3], v[4], v[5], v[6]};
+            i++;
+         }
+      }
+      if (i + 1 < argc && strcmp(argv[i], "-U") == 0)
+         sscanf(argv[++i], "%llu,%llu,%llu", &numCores, &threads, &quantum);
+      if (i + 1 < argc && strcmp(argv[i], "-V") == 0)
+         lanes = strtoull(argv[++i], NULL, 10);
+      if (i + 1 < argc && strcmp(argv[i], "-E") == 0)
+      {
+         unsigned long long f = 0, e = 0, m = 0;
+         sscanf(argv[++i], "%llu,%llu,%llu", &f, &e, &m);
+         DeepConfig depth = {f, e, m};
+         depths.push_back(depth);
+      }
+      if (strcmp(argv[i], "-F") == 0)
+      {
+         uint32_t mask = 0;
+         forwarding = true;
+         if (i + 1 < argc && argv[i + 1][0] != '-')
+         {
+            if (Forwarding::parsePaths(argv[++i], mask))
+               Forwarding::getInstance()->setEnabled(((1 << NUMFWDPATHS) - 1) & ~mask);
+            else badPaths = true;
+         }
+      }
+      if (strcmp(argv[i], "-H") == 0) profile = true;
+      if (strcmp(argv[i], "-Y") == 0)
+      {
+         accesses = true;
+         if (i + 1 < argc && sscanf(argv[i + 1], "%llu", &accessWindow) == 1) i++;
+      }
+      if (strcmp(argv[i], "-G") == 0)
+      {
+         calls = true;
+         if (i + 1 < argc && argv[i + 1][0] != '-') foldedName = argv[++i];
+      }
+      if (strcmp(argv[i], "-W") == 0)
+      {
+         energy = true;
+         if (i + 1 < argc && argv[i + 1][0] != '-') energyTable = argv[++i];
+      }
+      if (i + 1 < argc && strcmp(argv[i], "-B") == 0)
+      {
+         char * end;
+         uint64_t pc = strtoull(argv[++i], &end, 16);
+         if (end == argv[i] || *end != '\0') badTrigger = true;
+         else trigger->addBreakpoint(pc);
+      }
+      if (i + 1 < argc && strcmp(argv[i], "-M") == 0)
+      {
+         //addr or addr,len; the watched bytes have to be in memory
+         char * end;
+         uint64_t address = strtoull(argv[++i], &end, 16), length = 1;
+         bool parsed = end != argv[i];
+         if (parsed && *end == ',')
+         {
+            const char * start = end + 1;
+            length = strtoull(start, &end, 16);
+            parsed = end != start;
+         }
+         if (!parsed || *end != '\0' || length == 0 || address >= MEMSIZE ||
+             length > MEMSIZE - address) badTrigger = true;
+         else trigger->addMemoryWatch(address, length);
+      }
+      if (i + 1 < argc && strcmp(argv[i], "-R") == 0)
+      {
+         char * end;
+         uint64_t reg = strtoull(argv[++i], &end, 16);
+         if (end == argv[i] || *end != '\0' || reg >= REGSIZE)
+            badTrigger = true;
+         else trigger->addRegisterWatch(reg);
+      }
+      if (i + 1 < argc && strcmp(argv[i], "-C") == 0)
+      {
+         uint64_t ifun = LESSEQ;
+         i++;
+         while (ifun <= GREATER &&
+                strcmp(argv[i], Trigger::conditionName(ifun)) != 0) ifun++;
+         if (ifun <= GREATER) trigger->addCondition(ifun);
+         else badTrigger = true;
+      }
+      if (i + 1 < argc && strcmp(argv[i], "-N") == 0)
+         triggerWindow = strtoull(argv[++i], NULL, 10);
+      if (i + 1 < argc && strcmp(argv[i], "-L") == 0) logName = argv[++i];
+      if (i + 1 < argc && strcmp(argv[i], "-Z") == 0) printsName = argv[++i];
+      if (i + 1 < argc && strcmp(argv[i], "-j") == 0) exportFormat = argv[++i];
+      if (i + 1 < argc && strcmp(argv[i], "-f") == 0) exportFields = argv[++i];
+      if (i + 1 < argc && strcmp(argv[i], "-y") == 0 &&
+          sscanf(argv[++i], "%llu,%llu,%llu", &exportFirst, &exportLast,
+                 &exportStep) == 1)
+         exportLast = exportFirst;
+      if (strcmp(argv[i], "-b") == 0)
+      {
+         phased = true;
+         if (i + 1 < argc && sscanf(argv[i + 1], "%llu,%llu", &phaseInterval,
+                                    &maxPhases) >= 1) i++;
+      }
+      if (strcmp(argv[i], "-Q") == 0)
+      {
+         traced = true;
+         if (i + 1 < argc && argv[i + 1][0] != '-') traceName = argv[++i];
+      }
+      if (i + 1 < argc && strcmp(argv[i], "-K") == 0)
+         interval = strtoull(argv[++i], NULL, 10);
+      if (i + 1 < argc && strcmp(argv[i], "-P") == 0) replayCycles = argv[++i];
+      if (i + 1 < argc && strcmp(argv[i], "-A") == 0) batch = argv[++i];
+   }
+
+   if (badCategories)
+   {
+      std::cout << "Unknown trace category.\nUsage: yess <file.yo> -T "
+                << "category[,category...] where a category is fetch, decode, "
+                << "forward, execute, memory, writeback, loader or all\n";
+      return 0;
+   }
+   if (badPaths)
+   {
+      std::cout << "Unknown forwarding path.\nUsage: yess <file.yo> -F "
+                << "[path[,path...]] where a path is e_valE, m_valM, M_valE, "
+                << "W_valM, W_valE or all\n";
+      return 0;
+   }
+   if (badTrigger)
+   {
+      std::cout << "Bad trigger option.\nUsage: yess <file.yo> [-B pc] "
+                << "[-M addr[,len]] [-R reg] [-C cond] [-N window] where pc, "
+                << "addr, len and reg are hex, the watched bytes are below "
+                << "0x" << std::hex << MEMSIZE << std::dec << ", reg is below "
+                << REGSIZE << " and cond is le, l, e, ne, ge or g\n";
+      return 0;
+   }
+
+   if (replayCycles != NULL)
+   {
+      //argv[1] is a log written with -L
+      unsigned long long first = 0, last = 0;
+      int fields = sscanf(replayCycles, "%llu,%llu", &first, &last);
+      Machine machine;
+      if (fields < 1 || !ReplayLog::getInstance()->replay(machine, argv[1],
+                                 first, fields == 2 ? last : first))
+         std::cout << "Replay error.\nUsage: yess <log> -P first[,last]\n";
+      return 0;
+   }
+   if (batch != NULL)
+   {
+      //the reset only clears what the previous program wrote, so the
+      //programs run back to back without building a new machine
+      Machine machine;
+      std::string list = std::string(argv[1]) + "," + batch;
+      uint64_t start = 0;
+      while (start <= list.length())
+      {
+         uint64_t end = list.find(',', start);
+         if (end == std::string::npos) end = list.length();
+         std::string name = list.substr(start, end - start);
+         machine.reset();
+         std::cout << "\nProgram " << name << ":" << std::endl;
+         if (!machine.loadFile(name.c_str())) std::cout << "Load error.\n";
+         else
+         {
+            machine.runUntilHalt(UINT64_MAX);
+            machine.dump();
+         }
+         start = end + 1;
+      }
+      return 0;
+   }
+   if (sample && (window == 0 || warmup + window > period))
+   {
+      std::cout << "Sampling requires 0 < window and warmup + window <= period\n";
+      return 0;
+   }
+   if (numCores > 0 && (numCores > MAXCORES || threads == 0 ||
+                        threads > numCores || quantum == 0))
+   {
+      std::cout << "Multicore runs require 1 to " << MAXCORES
+                << " cores, 1 to cores threads and a nonzero quantum\n";
+      return 0;
+   }
+   if (accesses && accessWindow == 0)
+   {
+      std::cout << "The working set window must be at least one cycle\n";
+      return 0;
+   }
+   if (energyTable != NULL && !Energy::getInstance()->loadTable(energyTable))
+   {
+      std::cout << "Unable to read the energy table " << energyTable << std::endl;
+      return 0;
+   }
+   for (uint64_t i = 0; i < depths.size(); i++)
+   {
+      if (!DeepPipe::valid(depths[i]))
+      {
+         std::cout << "Pipeline depths require 1 to " << MAXSUBSTAGES
+                   << " fetch, execute and memory sub-stages\n";
+         return 0;
+      }
+   }
+   int32_t format = EXPORTJSON;
+   if (exportFormat != NULL && (!StateExport::parseFormat(exportFormat, format) ||
+       exportStep == 0 || exportLast < exportFirst))
+   {
+      std::cout << "State output requires -j json or csv and cycles first[,last[,step]]"
+                << " with first <= last and a nonzero step\n";
+      return 0;
+   }
+   StateExport exporter(format);
+   if (exportFields != NULL && !exporter.select(exportFields))
+   {
+      std::cout << "Unknown state value in " << exportFields << std::endl;
+      return 0;
+   }
+   if (traced && traceName == NULL)
+   {
+      //argv[1] is a trace written with -Q trace
+      std::vector<DeepPipe *> pipes;
+      for (uint64_t i = 0; i < depths.size(); i++)
+         pipes.push_back(new DeepPipe(depths[i]));
+      if (pipes.size() == 0 || !DeepPipe::replay(pipes, argv[1]))
+      {
+         std::cout << "Trace error.\nUsage: yess <trace> -Q -E fetch,execute,memory ...\n";
+         return 0;
+      }
+      for (uint64_t i = 0; i < pipes.size(); i++) pipes[i]->dump();
+      return 0;
+   }
+   if (phased && !PhaseProfile::valid(phaseInterval, maxPhases))
+   {
+      std::cout << "Phase detection requires an interval of at least one instruction and 1 to "
+                << PHASEMAXK << " phases\n";
+      return 0;
+   }
+   if (logName != NULL && interval == 0)
+   {
+      std::cout << "Replay logs require a keyframe interval of at least one cycle\n";
+      return 0;
+   }
+   if (lanes > MAXLANES)
+   {
+      std::cout << "Batch runs require 1 to " << MAXLANES << " lanes\n";
+      return 0;
+   }
+   if (outOfOrder && !OutOfOrder::valid(config))
+   {
+      std::cout << "The out-of-order core requires nonzero widths and sizes and at least "
+                << OOOARCHREGS + OOOMAXDESTS << " physical registers\n";
+      return 0;
+   }
 
    Memory * mem = Memory::getInstance();
-   Loader load(argc, argv);
-   if (!load.isLoaded())
+   Machine machine;
+   if (argc < 2 || !machine.loadFile(argv[1]))
    {
       std::cout << "Load error.\nUsage: yess <file.yo>\n";
       if (mem != NULL) mem->dump();
       return 0;
    }
+
+   if (translate)
+   {
+      Translator translator;
+      translator.run();
+      translator.dump();
+      return 0;
+   }
+
+   if (interpret)
+   {
+      //run the interpreter, then time the pipeline on the same
+      //program and restore the interpreter's final state
+      MachineState * initial = new MachineState();
+      MachineState * final = new MachineState();
+      Interpreter * interpreter = new Interpreter();
+      initial->save();
+      interpreter->run();
+      final->save();
+      initial->restore();
+
+      Simulate quiet;
+      std::chrono::steady_clock::time_point start =
+         std::chrono::steady_clock::now();
+      uint64_t cycles = quiet.runQuiet(4 * interpreter->getInstructions() + 100);
+      double seconds = std::chrono::duration<double>(
+         std::chrono::steady_clock::now() - start).count();
+      final->restore();
+
+      interpreter->dump();
+      double dispatchRate = interpreter->getDispatches() /
+                            interpreter->getSeconds();
+      double cycleRate = cycles / seconds;
+      std::cout << std::dec << "interpreter: " << (uint64_t) dispatchRate
+                << " dispatches/s " << (uint64_t) (interpreter->getInstructions()
+                / interpreter->getSeconds()) << " instructions/s" << std::endl;
+      std::cout << "pipeline: " << cycles << " cycles " << (uint64_t) cycleRate
+                << " cycles/s" << std::endl;
+      std::cout << "interpreter dispatches/s over pipeline cycles/s: "
+                << dispatchRate / cycleRate << std::endl;
+      return 0;
+   }
+
+   if (numCores > 0)
+   {
+      Multicore multicore(numCores, threads, quantum);
+      multicore.run();
+      multicore.dump();
+      return 0;
+   }
+
+   if (lanes > 0)
+   {
+      Batch batch(lanes);
+      batch.run();
+      batch.dump();
+      return 0;
+   }
+
+   if (depths.size() > 0)
+   {
+      std::vector<DeepPipe *> pipes;
+      for (uint64_t i = 0; i < depths.size(); i++)
+         pipes.push_back(new DeepPipe(depths[i]));
+      DeepPipe::run(pipes);
+      for (uint64_t i = 0; i < pipes.size(); i++) pipes[i]->dump();
+      ConditionCodes::getInstance()->dump();
+      RegisterFile::getInstance()->dump();
+      mem->dump();
+      return 0;
+   }
+
+   if (outOfOrder)
+   {
+      //run the out-of-order core, then time the pipeline on the same
+      //program and restore the core's final state. The pipeline does
+      //not squash, so its IPC is the program's instructions (the ones
+      //the core commits) over its cycles, not what W retires.
+      MachineState initial, final;
+      OutOfOrder core(config);
+      initial.save();
+      core.run();
+      final.save();
+      initial.restore();
+
+      Simulate quiet;
+      uint64_t cycles = quiet.runQuiet(4 * core.getInstructions() + 100);
+      final.restore();
+
+      core.dump();
+      std::cout << std::dec << "pipeline: " << cycles << " cycles IPC: "
+                << (double) core.getInstructions() / cycles << std::endl;
+      return 0;
+   }
+
+   if (phased)
+   {
+      PhaseProfile phases(phaseInterval, maxPhases);
+      phases.run();
+      phases.dump();
+      return 0;
+   }
+
+   if (sample)
+   {
+      Sampler sampler(period, warmup, window);
+      sampler.run();
+      sampler.dump();
+      return 0;
+   }
   
-   Simulate simulate;
-   simulate.run(); 
+   if (traceName != NULL)
+   {
+      if (!InstrTrace::record(traceName))
+         std::cout << "Unable to write " << traceName << std::endl;
+      return 0;
+   }
+
+   if (exportFormat != NULL)
+   {
+      exporter.run(machine, exportFirst, exportLast, exportStep, std::cout);
+      return 0;
+   }
+
+   if (logName != NULL)
+   {
+      if (!ReplayLog::getInstance()->record(machine, logName, interval))
+         std::cout << "Unable to write " << logName << std::endl;
+      return 0;
+   }
+
+   if (printsName != NULL)
+   {
+      if (!Fingerprint::getInstance()->record(machine, printsName))
+         std::cout << "Unable to write " << printsName << std::endl;
+      return 0;
+   }
+
+   //only the pipeline runs below are timed, so the profiler is never
+   //shared by several host threads
+   Profiler::setEnabled(profile);
+   AccessProfile::getInstance()->setWindow(accessWindow);
+   AccessProfile::setEnabled(accesses);
+   CallProfile::setEnabled(calls);
+   if (energy)
+   {
+      PipeReg * pregs[NUMPIPEREGS];
+      for (int32_t i = 0; i < NUMPIPEREGS; i++) pregs[i] = machine.getPipeReg(i);
+      Energy::getInstance()->bind(pregs);
+      Energy::setEnabled(true);
+   }
+   if (trigger->isSet())
+   {
+      trigger->run(machine, triggerWindow);
+      if (profile) Profiler::dump();
+      if (accesses) AccessProfile::getInstance()->dump();
+      if (calls) dumpCalls(foldedName);
+      if (energy) Energy::getInstance()->dump();
+      return 0;
+   }
+
+   //dump the machine state at the end of every cycle until a halt
+   //reaches the writeback stage; unless trace output has to appear
+   //between the dumps, they are written by a background thread
+   if (trace)
+   {
+      while (!machine.isHalted())
+      {
+         machine.step(1);
+         machine.dump();
+      }
+   }
+   else
+   {
+      OutputWriter writer(&machine);
+      while (!machine.isHalted())
+      {
+         machine.step(1);
+         writer.put();
+      }
+      writer.finish();
+   }
+   if (trace && Debug::anyCompiled()) Debug::dumpCounts();
+   if (forwarding) Forwarding::getInstance()->dump();
+   if (profile) Profiler::dump();
+   if (accesses) AccessProfile::getInstance()->dump();
+   if (calls) dumpCalls(foldedName);
+   if (energy) Energy::getInstance()->dump();
    
    return 0;
 }
@@ -0,0 +1,57 @@
+/*
+ * Benchmark of the pipeline's cycle loop
+ * Usage: yessbench <file>.yo [repetitions]
+ *
+ * Runs the program in <file>.yo through Simulate::doClockLow and
+ * doClockHigh repetitions times (default 1000), at most 2000 cycles
+ * each, without dumping any state, and outputs the host nanoseconds
+ * per simulated cycle. It only uses the Loader and Simulate, so
+ * bench.sh can build it against the sources of any revision to
+ * compare them.
+*/
+
+#include <chrono>
+#include <iostream>
+#include <cstdint>
+#include <string>
+#include <stdlib.h>
+#include "PipeReg.h"
+#include "Stage.h"
+#include "Simulate.h"
+#include "Loader.h"
+#include "Memory.h"
+
+//the debug flag of revisions before the trace categories
+int debug = 0;
+
+int main(int argc, char * argv[])
+{
+   Loader loader(argc, argv);
+   if (!loader.isLoaded())
+   {
+      std::cout << "Load error.\nUsage: yessbench <file.yo> [repetitions]\n";
+      return 0;
+   }
+   uint64_t repetitions = argc > 2 ? strtoull(argv[2], NULL, 10) : 1000;
+   uint64_t cycles = 0;
+   double ns = 0;
+   for (uint64_t rep = 0; rep < repetitions; rep++)
+   {
+      Simulate simulate;
+      bool stop = false;
+      uint64_t cycle = 0;
+      std::chrono::steady_clock::time_point start =
+         std::chrono::steady_clock::now();
+      while (!stop && cycle < 2000)
+      {
+         stop = simulate.doClockLow();
+         simulate.doClockHigh();
+         cycle++;
+      }
+      ns += std::chrono::duration<double, std::nano>(
+         std::chrono::steady_clock::now() - start).count();
+      cycles += cycle;
+   }
+   std::cout << "cycles: " << cycles << " ns/cycle: " << ns / cycles << std::endl;
+   return 0;
+}
@@ -0,0 +1,31 @@
+/*
+ * Compares two fingerprint files written by yess -Z
+ * Usage: yesscmp first second
+ *
+ * Outputs the number of cycles in which the runs that wrote the files
+ * have the same state or the first cycle (numbered as in the dumps of
+ * yess) in which they differ and the components of the state that
+ * differ in it: the F, D, E, M and W registers, the registers, the
+ * condition codes or the memory. The exit status is 0 if the files
+ * match, 1 if they differ and 2 if either cannot be read.
+*/
+
+#include <iostream>
+#include <cstdint>
+#include "Memory.h"
+#include "RegisterFile.h"
+#include "Tools.h"
+#include "PipeReg.h"
+#include "ReplayLog.h"
+#include "Fingerprint.h"
+
+int main(int argc, char * argv[])
+{
+   if (argc != 3)
+   {
+      std::cout << "Usage: yesscmp first second\n";
+      return 2;
+   }
+   int32_t result = Fingerprint::compare(argv[1], argv[2]);
+   return result < 0 ? 2 : result;
+}
@@ -0,0 +1,44 @@
+/*
+ * Generator of random y86-64 programs for the yess simulator
+ * Usage: yessgen seed [size [alu,memory,call,loop[,iterations]]]
+ *
+ * Outputs to stdout a program in .yo format that the Loader accepts.
+ * seed selects the program; the same arguments always give the same
+ * program. size is the approximate number of bytes of code (default
+ * 0x800, hex with a 0x prefix). alu, memory, call and loop are the
+ * weights of ALU chains, loads and stores, calls of leaf functions and
+ * loops with data-dependent branches in the mix (default 4,2,1,1), and
+ * each loop runs 1 to iterations times (default 16). The program runs
+ * the same on every engine of yess and always halts.
+*/
+
+#include <iostream>
+#include <stdio.h>
+#include <stdlib.h>
+#include "Memory.h"
+#include "Generator.h"
+
+int main(int argc, char * argv[])
+{
+   GenConfig config = {0, GENSIZE, GENALU, GENMEMORY, GENCALL, GENLOOP,
+                       GENITERATIONS};
+   unsigned long long v[5] = {GENALU, GENMEMORY, GENCALL, GENLOOP,
+                              GENITERATIONS};
+
+   if (argc > 1) config.seed = strtoull(argv[1], NULL, 0);
+   if (argc > 2) config.size = strtoull(argv[2], NULL, 0);
+   if (argc > 3 && sscanf(argv[3], "%llu,%llu,%llu,%llu,%llu", &v[0], &v[1],
+                          &v[2], &v[3], &v[4]) >= 4)
+      config = {config.seed, config.size, v[0], v[1], v[2], v[3], v[4]};
+   if (argc < 2 || !Generator::valid(config))
+   {
+      std::cout << "Usage: yessgen seed [size [alu,memory,call,loop[,iterations]]]\n"
+                << "size is " << GENMINSIZE << " to " << GENMAXSIZE
+                << " bytes and iterations is at least 1\n";
+      return 0;
+   }
+
+   Generator generator(config);
+   std::cout << generator.generate();
+   return 0;
+}